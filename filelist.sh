@@ -2,8 +2,18 @@
 #
 # Automatic resource file list generation
 # Created by Dimok
+#
+# Besides the list itself a minimal perfect hash over the lower case file names
+# is generated (hash and displace), so a name resolves to its entry with one
+# hash and one compare, at compile time if the name is a constant.
+
+export LC_ALL=C
 
 outFile="./src/resources/filelist.h"
+idsFile="./src/resources/filelist_ids.h"
+generator="7"
+# must match the extensions the Makefile runs through tools/zpack.py
+compressedExt="png ttf mp3"
 count_old=$(cat $outFile 2>/dev/null | tr -d '\n\n' | sed 's/[^0-9]*\([0-9]*\).*/\1/')
 
 count=0
@@ -26,15 +36,108 @@ done
 
 fi
 
-if [ "$count_old" != "$count" ] || [ ! -f $outFile ]
+# FNV-1a over the name with bit 5 of every byte set, which folds the case of letters
+# without a branch. Must match RecourceHash() in the generated header.
+hash_name()
+{
+	local h=2166136261
+	local name="$1"
+	local n c
+	for (( n=0; n<${#name}; n++ ))
+	do
+		printf -v c '%d' "'${name:n:1}"
+		h=$(( ((h ^ (c | 0x20)) * 16777619) & 0xFFFFFFFF ))
+	done
+	hash=$h
+}
+
+# Remixes the name hash with a bucket seed. Must match RecourceMix() in the generated header.
+mix_hash()
+{
+	local h=$(( (($1 ^ $2) * 2654435761) & 0xFFFFFFFF ))
+	mixed=$(( h ^ (h >> 16) ))
+}
+
+if [ "$count_old" != "$count" ] || [ ! -f $outFile ] || [ ! -f $idsFile ] || ! grep -q "Generator version $generator\." $outFile
 then
 
 echo "Generating filelist.h for $count files." >&2
-cat <<EOF > $outFile
+
+buckets=$count
+if [ $buckets -eq 0 ]; then
+	buckets=1
+fi
+
+# first level: spread the names over the buckets
+for (( b=0; b<buckets; b++ ))
+do
+	bucket[b]=""
+	displacement[b]=0
+done
+for (( n=0; n<count; n++ ))
+do
+	hash_name "${files[n]}"
+	hashes[n]=$hash
+	b=$((hash % buckets))
+	bucket[b]="${bucket[b]} $n"
+done
+
+# second level: largest buckets first, find a seed which moves all names of the bucket into free slots
+for (( s=0; s<count; s++ ))
+do
+	slot[s]=-1
+done
+for b in $(for (( b=0; b<buckets; b++ )); do set -- ${bucket[b]}; echo "$# $b"; done | sort -rn | cut -d' ' -f2)
+do
+	set -- ${bucket[b]}
+	if [ $# -eq 0 ]; then
+		continue
+	fi
+	if [ $# -eq 1 ]; then
+		# single names take the first free slot directly, stored as -(slot + 1)
+		for (( s=0; s<count; s++ ))
+		do
+			if [ ${slot[s]} -lt 0 ]; then
+				slot[s]=$1
+				displacement[b]=$(( -s - 1 ))
+				break
+			fi
+		done
+		continue
+	fi
+	seed=1
+	while true
+	do
+		taken=""
+		ok=1
+		for n in $@
+		do
+			mix_hash ${hashes[n]} $seed
+			s=$((mixed % count))
+			if [ ${slot[s]} -ge 0 ] || [[ " $taken " == *" $s "* ]]; then
+				ok=0
+				break
+			fi
+			taken="$taken $s"
+		done
+		if [ $ok -eq 1 ]; then
+			break
+		fi
+		seed=$((seed + 1))
+	done
+	displacement[b]=$seed
+	for n in $@
+	do
+		mix_hash ${hashes[n]} $seed
+		slot[$((mixed % count))]=$n
+	done
+done
+
+cat <<EOF2 > $outFile
 /****************************************************************************
  * Resource files.
  * This file is generated automatically.
- * Includes $count files.
+ * Includes $count files. Generator version $generator.
  *
  * NOTE:
  * Any manual modification of this file will be overwriten by the generation.
@@ -42,6 +145,8 @@ cat <<EOF > $outFile
 #ifndef _FILELIST_H_
 #define _FILELIST_H_
 
+#include "filelist_ids.h"
+
 typedef struct _RecourceFile
 {
 	const char          *filename;
@@ -49,9 +154,12 @@ typedef struct _RecourceFile
 	const unsigned int  &DefaultFileSize;
 	unsigned char	    *CustomFile;
 	unsigned int        CustomFileSize;
+	bool                DefaultCompressed;
+	unsigned char       *InflatedFile;
+	unsigned int        InflatedFileSize;
 } RecourceFile;
 
-EOF
+EOF2
 
 for i in ${files[@]}
 do
@@ -61,20 +169,108 @@ do
 done
 
 echo '' >> $outFile
+echo '//! ordered by hash slot, index = RecourceIndex(filename)' >> $outFile
 echo 'static RecourceFile RecourceList[] =' >> $outFile
 echo '{' >> $outFile
 
-for i in ${files[@]}
+for (( s=0; s<count; s++ ))
 do
+	i=${files[${slot[s]}]}
 	filename=${i%.*}
 	extension=${i##*.}
-	echo -e '\t{"'$i'", '$filename'_'$extension', '$filename'_'$extension'_size, NULL, 0},' >> $outFile
+	compressed=false
+	if [[ " $compressedExt " == *" $extension "* ]]; then
+		compressed=true
+	fi
+	echo -e '\t{"'$i'", '$filename'_'$extension', '$filename'_'$extension'_size, NULL, 0, '$compressed', NULL, 0},' >> $outFile
 done
 
-echo -e '\t{NULL, NULL, 0, NULL, 0}' >> $outFile
+echo -e '\t{NULL, NULL, 0, NULL, 0, false, NULL, 0}' >> $outFile
 echo '};' >> $outFile
 
 echo '' >> $outFile
 echo '#endif' >> $outFile
 
+cat <<EOF2 > $idsFile
+/****************************************************************************
+ * Resource file ids.
+ * This file is generated automatically by filelist.sh.
+ *
+ * NOTE:
+ * Any manual modification of this file will be overwriten by the generation.
+ ****************************************************************************/
+#ifndef _FILELIST_IDS_H_
+#define _FILELIST_IDS_H_
+
+#include <stdint.h>
+#include <strings.h>
+
+#define RECOURCE_COUNT   $count
+#define RECOURCE_BUCKETS $buckets
+
+EOF2
+
+echo 'static constexpr int32_t RecourceDisplacement[RECOURCE_BUCKETS] = {' >> $idsFile
+for (( b=0; b<buckets; b++ ))
+do
+	echo -e '\t'${displacement[b]}',' >> $idsFile
+done
+echo '};' >> $idsFile
+echo '' >> $idsFile
+
+echo 'static constexpr const char *RecourceNames[RECOURCE_COUNT + 1] = {' >> $idsFile
+for (( s=0; s<count; s++ ))
+do
+	echo -e '\t"'${files[${slot[s]}]}'",' >> $idsFile
+done
+echo -e '\tnullptr,' >> $idsFile
+echo '};' >> $idsFile
+
+cat <<'EOF2' >> $idsFile
+
+static constexpr char RecourceLower(char c) {
+    return (c >= 'A' && c <= 'Z') ? (char) (c - 'A' + 'a') : c;
+}
+
+static constexpr uint32_t RecourceHash(const char *name) {
+    uint32_t hash = 2166136261u;
+    for (; *name; ++name) {
+        hash = (hash ^ ((uint8_t) *name | 0x20)) * 16777619u;
+    }
+    return hash;
+}
+
+static constexpr uint32_t RecourceMix(uint32_t hash, uint32_t seed) {
+    uint32_t mixed = (hash ^ seed) * 2654435761u;
+    return mixed ^ (mixed >> 16);
+}
+
+static constexpr bool RecourceNameEquals(const char *a, const char *b) {
+    if (!__builtin_is_constant_evaluated())
+        return strcasecmp(a, b) == 0;
+
+    for (; *a && *b; ++a, ++b) {
+        if (RecourceLower(*a) != RecourceLower(*b))
+            return false;
+    }
+    return *a == *b;
+}
+
+//! Index into RecourceList or -1 if the file is not embedded
+static constexpr int32_t RecourceIndex(const char *name) {
+    if (!name || RECOURCE_COUNT == 0)
+        return -1;
+
+    uint32_t hash        = RecourceHash(name);
+    int32_t displacement = RecourceDisplacement[hash % RECOURCE_BUCKETS];
+    uint32_t slot        = (displacement < 0) ? (uint32_t) (-displacement - 1) : RecourceMix(hash, displacement) % RECOURCE_COUNT;
+    if (slot >= RECOURCE_COUNT || !RecourceNameEquals(RecourceNames[slot], name))
+        return -1;
+
+    return slot;
+}
+
+#endif
+EOF2
+
 fi
@@ -16,8 +16,14 @@
  ****************************************************************************/
 #include "Application.h"
 #include "common/common.h"
+#include "fs/FSStatCache.h"
+#include "fs/FSUtils.h"
+#include "fs/IOTracer.h"
+#include "gui/GlyphCacheWarmer.h"
 #include "resources/Resources.h"
+#include "resources/SfxPool.h"
 #include "utils/AsyncExecutor.h"
+#include "utils/MemoryAccounting.h"
 #include "utils/logger.h"
 #include <coreinit/core.h>
 #include <coreinit/foreground.h>
@@ -37,18 +43,18 @@ bool Application::quitRequest                 = false;
 
 Application::Application()
     : CThread(CThread::eAttributeAffCore1 | CThread::eAttributePinnedAff, 0, 0x800000), bgMusic(nullptr), video(nullptr), mainWindow(nullptr), fontSystem(nullptr), exitCode(0) {
+    if (FSUtils::CheckFile(IO_TRACE_ENABLE_PATH)) {
+        IOTracer::Start();
+    }
+    //! only the folder is checked here, each override is read when its resource is first used
+    Resources::LoadFiles(RESOURCE_OVERRIDE_PATH);
+
     controller[0] = new VPadController(GuiTrigger::CHANNEL_1);
     controller[1] = new WPadController(GuiTrigger::CHANNEL_2);
     controller[2] = new WPadController(GuiTrigger::CHANNEL_3);
     controller[3] = new WPadController(GuiTrigger::CHANNEL_4);
     controller[4] = new WPadController(GuiTrigger::CHANNEL_5);
 
-    //! create bgMusic
-    bgMusic = new GuiSound(Resources::GetFile("bgMusic.ogg"), Resources::GetFileSize("bgMusic.ogg"));
-    bgMusic->SetLoop(true);
-    bgMusic->Play();
-    bgMusic->SetVolume(50);
-
     AsyncExecutor::execute([] { DEBUG_FUNCTION_LINE("Hello"); });
 
     exitApplication = false;
@@ -58,7 +64,7 @@ Application::Application()
 
 Application::~Application() {
     DEBUG_FUNCTION_LINE("Destroy music");
-    delete bgMusic;
+    stopAudio();
 
     DEBUG_FUNCTION_LINE("Destroy controller");
 
@@ -66,6 +72,12 @@ Application::~Application() {
         delete i;
     }
 
+    MemoryAccounting::LogStats();
+
+    //! before the resources, a preload which is still running may read an override
+    DEBUG_FUNCTION_LINE("Clear sound effects");
+    SfxPool::Clear();
+
     DEBUG_FUNCTION_LINE("Clear resources");
     Resources::Clear();
 
@@ -75,6 +87,11 @@ Application::~Application() {
     DEBUG_FUNCTION_LINE("Clear AsyncExecutor");
     AsyncExecutor::destroyInstance();
 
+    if (IOTracer::IsActive()) {
+        IOTracer::Dump(IO_TRACE_DUMP_PATH);
+        IOTracer::Stop();
+    }
+
     ProcUIShutdown();
 }
 
@@ -93,6 +110,30 @@ void Application::quit(int32_t code) {
     quitRequest     = true;
 }
 
+void Application::startAudio() {
+    //! click sounds are decoded once in the background, not on the first click or the GUI thread
+    SfxPool::PreloadAsync(RESOURCE_ID("button_click.mp3"));
+    SfxPool::PreloadAsync(RESOURCE_ID("settings_click_2.mp3"));
+
+    if (bgMusic == nullptr) {
+        //! the sound handler thread streams the ogg from the embedded data in small buffers
+        BlobView bgMusicBlob = Resources::GetBlob(RESOURCE_ID("bgMusic.ogg"));
+        bgMusic              = new GuiSound(bgMusicBlob.getData(), bgMusicBlob.getSize());
+        bgMusic->SetLoop(true);
+        bgMusic->SetVolume(50);
+        bgMusic->Play();
+    }
+}
+
+void Application::stopAudio() {
+    if (bgMusic != nullptr) {
+        //! releases the decoder and its voice, the music starts over when we are back
+        bgMusic->Stop();
+        delete bgMusic;
+        bgMusic = nullptr;
+    }
+}
+
 void Application::fadeOut() {
     GuiImage fadeOut(video->getTvWidth(), video->getTvHeight(), (GX2Color){0, 0, 0, 255});
 
@@ -123,6 +164,9 @@ void Application::fadeOut() {
 
         video->tvDrawDone();
 
+        //! icons evicted while the frame was drawn are not shown anymore
+        mainWindow->freeEvictedIcons();
+
         //! as last point update the effects as it can drop elements
         mainWindow->updateEffects();
 
@@ -142,14 +186,19 @@ bool Application::procUI() {
         }
         case PROCUI_STATUS_RELEASE_FOREGROUND: {
             DEBUG_FUNCTION_LINE("PROCUI_STATUS_RELEASE_FOREGROUND");
+            stopAudio();
+            Resources::EvictForBackground();
+            FSStatCache::LogStats();
+            MemoryAccounting::LogStats();
+            if (IOTracer::IsActive()) {
+                IOTracer::Dump(IO_TRACE_DUMP_PATH);
+            }
             if (video != nullptr) {
                 // we can turn ofF the screen but we don't need to and it will display the last image
                 video->tvEnable(true);
                 video->drcEnable(true);
 
-                DEBUG_FUNCTION_LINE("delete fontSystem");
-                delete fontSystem;
-                fontSystem = nullptr;
+                //! the font stays, the GuiTexts of the main window keep using it
 
                 DEBUG_FUNCTION_LINE("delete video");
                 delete video;
@@ -174,10 +223,24 @@ bool Application::procUI() {
                     video = new CVideo(GX2_TV_SCAN_MODE_720P, GX2_DRC_RENDER_MODE_SINGLE);
                     DEBUG_FUNCTION_LINE("Video size %i x %i", video->getTvWidth(), video->getTvHeight());
 
-                    //! setup default Font
-                    DEBUG_FUNCTION_LINE("Initialize main font system");
-                    auto *fontSystem = new FreeTypeGX(Resources::GetFile("font.ttf"), Resources::GetFileSize("font.ttf"), true);
+                    //! the font and the textures of the first frame are loaded in parallel
+                    Resources::WarmUp();
+
+                    //! setup default Font, it is created once and keeps its glyph cache over background switches
+                    if (fontSystem == nullptr) {
+                        DEBUG_FUNCTION_LINE("Initialize main font system");
+                        BlobView font = Resources::GetBlob(RESOURCE_ID("font.ttf"));
+                        fontSystem    = new FreeTypeGX(font.getData(), font.getSize(), true);
+
+                        //! printable ASCII covers the UI and most title names
+                        std::string ascii;
+                        for (char c = 0x20; c < 0x7F; c++) {
+                            ascii += c;
+                        }
+                        GlyphCacheWarmer::push(ascii);
+                    }
                     GuiText::setPresetFont(fontSystem);
+                    GlyphCacheWarmer::setFont(fontSystem);
 
                     if (mainWindow == nullptr) {
                         DEBUG_FUNCTION_LINE("Initialize main window");
@@ -227,16 +290,23 @@ void Application::executeThread() {
         mainWindow->drawTv(video);
         video->tvDrawDone();
 
-        //! enable screen after first frame render
+        //! icons evicted while the frame was drawn are not shown anymore
+        mainWindow->freeEvictedIcons();
+
+        //! enable screen after first frame render, audio is started once something is visible
         if (video->getFrameCount() == 0) {
             video->tvEnable(true);
             video->drcEnable(true);
+            startAudio();
         }
 
         //! as last point update the effects as it can drop elements
         mainWindow->updateEffects();
         mainWindow->unlockGUI();
 
+        //! rasterize a few upcoming glyphs in the time left of this frame
+        GlyphCacheWarmer::process(8);
+
         video->waitForVSync();
     }
 
@@ -249,6 +319,7 @@ void Application::executeThread() {
     mainWindow = nullptr;
 
     DEBUG_FUNCTION_LINE("delete fontSystem");
+    GlyphCacheWarmer::setFont(nullptr);
     delete fontSystem;
     fontSystem = nullptr;
 
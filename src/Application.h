@@ -64,6 +64,10 @@ private:
 
     bool procUI(void);
 
+    void startAudio(void);
+
+    void stopAudio(void);
+
     static Application *applicationInstance;
     static bool exitApplication;
     static bool quitRequest;
@@ -5,8 +5,19 @@
 extern "C" {
 #endif
 
-#define LAUNCHIINE_VERSION "v0.1"
-#define META_PATH          "/meta"
+#define LAUNCHIINE_VERSION     "v0.1"
+#define META_PATH              "/meta"
+
+//! files in this folder replace the embedded resources of the same name
+#define RESOURCE_OVERRIDE_PATH "fs:/vol/external01/wiiu/launchiine/resources"
+
+//! create this file on the SD card to record the file accesses, the trace is written to IO_TRACE_DUMP_PATH
+#define IO_TRACE_ENABLE_PATH   "fs:/vol/external01/wiiu/launchiine/iotrace"
+#define IO_TRACE_DUMP_PATH     "fs:/vol/external01/wiiu/launchiine/iotrace.bin"
+
+//! written when a title is launched, the next start shows the same page from it
+#define SESSION_SNAPSHOT_DIR   "fs:/vol/external01/wiiu/launchiine"
+#define SESSION_SNAPSHOT_PATH  "fs:/vol/external01/wiiu/launchiine/session.bin"
 
 #ifdef __cplusplus
 }
@@ -1,11 +1,14 @@
 
 #include <fs/CFile.hpp>
+#include <fs/FSStatCache.h>
+#include <fs/IFileSystem.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <strings.h>
 
 CFile::CFile() {
+    fs       = nullptr;
     iFd      = -1;
     mem_file = nullptr;
     filesize = 0;
@@ -13,11 +16,13 @@ CFile::CFile() {
 }
 
 CFile::CFile(const std::string &filepath, eOpenTypes mode) {
+    fs  = nullptr;
     iFd = -1;
     this->open(filepath, mode);
 }
 
 CFile::CFile(const uint8_t *mem, int32_t size) {
+    fs  = nullptr;
     iFd = -1;
     this->open(mem, size);
 }
@@ -53,13 +58,20 @@ int32_t CFile::open(const std::string &filepath, eOpenTypes mode) {
     //! on the second launch it causes issues because we don't overwrite
     //! the .data sections which is needed for a normal application to re-init
     //! this will be added with launching as RPX
-    iFd = ::open(filepath.c_str(), openMode);
+    if (mode != ReadOnly) {
+        //! the file gets created or changed, the cached stat is stale afterwards
+        writePath = filepath;
+        FSStatCache::Invalidate(writePath);
+    }
+
+    fs  = IFileSystem::get();
+    iFd = fs->open(filepath.c_str(), openMode);
     if (iFd < 0)
         return iFd;
 
 
-    filesize = ::lseek(iFd, 0, SEEK_END);
-    ::lseek(iFd, 0, SEEK_SET);
+    filesize = fs->lseek(iFd, 0, SEEK_END);
+    fs->lseek(iFd, 0, SEEK_SET);
 
     return 0;
 }
@@ -75,7 +87,12 @@ int32_t CFile::open(const uint8_t *mem, int32_t size) {
 
 void CFile::close() {
     if (iFd >= 0)
-        ::close(iFd);
+        fs->close(iFd);
+
+    if (!writePath.empty()) {
+        FSStatCache::Invalidate(writePath);
+        writePath.clear();
+    }
 
     iFd      = -1;
     mem_file = nullptr;
@@ -85,7 +102,7 @@ void CFile::close() {
 
 int32_t CFile::read(uint8_t *ptr, size_t size) {
     if (iFd >= 0) {
-        int32_t ret = ::read(iFd, ptr, size);
+        int32_t ret = fs->read(iFd, ptr, size);
         if (ret > 0)
             pos += ret;
         return ret;
@@ -112,7 +129,7 @@ int32_t CFile::write(const uint8_t *ptr, size_t size) {
     if (iFd >= 0) {
         size_t done = 0;
         while (done < size) {
-            int32_t ret = ::write(iFd, ptr, size - done);
+            int32_t ret = fs->write(iFd, ptr, size - done);
             if (ret <= 0)
                 return ret;
 
@@ -145,7 +162,7 @@ int32_t CFile::seek(long int offset, int32_t origin) {
     }
 
     if (iFd >= 0)
-        ret = ::lseek(iFd, pos, SEEK_SET);
+        ret = fs->lseek(iFd, pos, SEEK_SET);
 
     if (mem_file != nullptr) {
         if (pos > filesize) {
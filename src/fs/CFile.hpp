@@ -8,6 +8,8 @@
 #include <unistd.h>
 #include <wut_types.h>
 
+class IFileSystem;
+
 class CFile {
 public:
     enum eOpenTypes {
@@ -62,10 +64,13 @@ public:
     };
 
 protected:
+    //! backend the file was opened with
+    IFileSystem *fs;
     int32_t iFd;
     const uint8_t *mem_file;
     uint64_t filesize;
     uint64_t pos;
+    std::string writePath;
 };
 
 #endif
@@ -25,15 +25,19 @@
  * for WiiXplorer 2010
  ***************************************************************************/
 #include <algorithm>
+#include <atomic>
+#include <future>
+#include <mutex>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <string>
 #include <strings.h>
-#include <sys/dirent.h>
 #include <sys/stat.h>
 
 #include <fs/DirList.h>
+#include <fs/FSStatCache.h>
+#include <fs/IFileSystem.h>
 #include <utils/StringTools.h>
 
 DirList::DirList() {
@@ -74,79 +78,156 @@ BOOL DirList::LoadPath(const std::string &folder, const char *filter, uint32_t f
         folderpath += '/';
     }
 
-    return InternalLoadPath(folderpath);
+    if ((Flags & CheckSubfolders) && (Flags & ParallelScan) && (Depth > 0))
+        return InternalLoadPathParallel(folderpath);
+
+    return InternalLoadPath(folderpath, Depth, FileInfo);
+}
+
+BOOL DirList::IsListed(const char *filename, BOOL isDir) const {
+    if (isDir ? !(Flags & Dirs) : !(Flags & Files))
+        return false;
+
+    if (!Filter)
+        return true;
+
+    const char *fileext = strrchr(filename, '.');
+    if (!fileext)
+        return false;
+
+    return StringTools::strtokcmp(fileext, Filter, ",") == 0;
 }
 
-BOOL DirList::InternalLoadPath(std::string &folderpath) {
+BOOL DirList::InternalLoadPath(std::string &folderpath, uint32_t depth, std::vector<DirEntry> &list) const {
     if (folderpath.size() < 3)
         return false;
 
-    struct dirent *dirent = nullptr;
-    DIR *dir              = nullptr;
+    IFileSystem *fs = IFileSystem::get();
+    IFileSystem::DirItem dirent;
 
-    dir = opendir(folderpath.c_str());
+    void *dir = fs->opendir(folderpath.c_str());
     if (dir == nullptr)
         return false;
 
-    while ((dirent = readdir(dir)) != 0) {
-        BOOL isDir           = dirent->d_type & DT_DIR;
-        const char *filename = dirent->d_name;
+    while (fs->readdir(dir, &dirent)) {
+        BOOL isDir           = dirent.isDir;
+        const char *filename = dirent.name.c_str();
 
         if (isDir) {
             if (strcmp(filename, ".") == 0 || strcmp(filename, "..") == 0)
                 continue;
 
-            if ((Flags & CheckSubfolders) && (Depth > 0)) {
+            if ((Flags & CheckSubfolders) && (depth > 0)) {
                 int32_t length = folderpath.size();
                 if (length > 2 && folderpath[length - 1] != '/') {
                     folderpath += '/';
                 }
                 folderpath += filename;
 
-                Depth--;
-                InternalLoadPath(folderpath);
+                InternalLoadPath(folderpath, depth - 1, list);
                 folderpath.erase(length);
-                Depth++;
             }
+        }
+
+        if (IsListed(filename, isDir))
+            AddEntrie(list, folderpath, filename, isDir);
+    }
+    fs->closedir(dir);
+
+    return true;
+}
+
+BOOL DirList::InternalLoadPathParallel(const std::string &folderpath) {
+    if (folderpath.size() < 3)
+        return false;
+
+    IFileSystem *fs = IFileSystem::get();
+    IFileSystem::DirItem dirent;
 
-            if (!(Flags & Dirs))
+    void *dir = fs->opendir(folderpath.c_str());
+    if (dir == nullptr)
+        return false;
+
+    const bool unordered = (Flags & UnorderedScan) != 0;
+
+    //! The entries of this folder and the results of the sub folders are kept in segments
+    //! which are concatenated in readdir order once all sub folders are scanned. This gives
+    //! exactly the same list as the serial scan (sub folder content before the folder itself).
+    std::vector<std::vector<DirEntry>> segments(1);
+    std::vector<std::pair<std::string, uint32_t>> subfolders;
+
+    while (fs->readdir(dir, &dirent)) {
+        BOOL isDir           = dirent.isDir;
+        const char *filename = dirent.name.c_str();
+
+        if (isDir) {
+            if (strcmp(filename, ".") == 0 || strcmp(filename, "..") == 0)
                 continue;
-        } else if (!(Flags & Files)) {
-            continue;
+
+            std::string subfolder(folderpath);
+            if (subfolder.size() > 2 && subfolder[subfolder.size() - 1] != '/') {
+                subfolder += '/';
+            }
+            subfolder += filename;
+
+            subfolders.emplace_back(subfolder, segments.size());
+            segments.resize(segments.size() + 2);
         }
 
-        if (Filter) {
-            char *fileext = strrchr(filename, '.');
-            if (!fileext)
+        if (IsListed(filename, isDir))
+            AddEntrie(segments.back(), folderpath, filename, isDir);
+    }
+    fs->closedir(dir);
+
+    //! a fixed number of workers takes the sub folders in readdir order, the caller is one of them
+    std::atomic<uint32_t> nextSubfolder{0};
+    std::mutex listMutex;
+    auto worker = [&]() {
+        for (uint32_t i = nextSubfolder++; i < subfolders.size(); i = nextSubfolder++) {
+            std::vector<DirEntry> result;
+            InternalLoadPath(subfolders[i].first, Depth - 1, result);
+            if (!unordered) {
+                segments[subfolders[i].second].swap(result);
                 continue;
-
-            if (StringTools::strtokcmp(fileext, Filter, ",") == 0)
-                AddEntrie(folderpath, filename, isDir);
-        } else {
-            AddEntrie(folderpath, filename, isDir);
+            }
+            std::lock_guard<std::mutex> lock(listMutex);
+            FileInfo.insert(FileInfo.end(), result.begin(), result.end());
         }
+    };
+
+    uint32_t workerCount = std::min<uint32_t>(SCAN_WORKERS, subfolders.size());
+    std::vector<std::future<void>> workers;
+    for (uint32_t i = 1; i < workerCount; i++) {
+        workers.push_back(std::async(std::launch::async, worker));
+    }
+    worker();
+    for (auto &w : workers) {
+        w.wait();
+    }
+
+    for (auto const &segment : segments) {
+        FileInfo.insert(FileInfo.end(), segment.begin(), segment.end());
     }
-    closedir(dir);
 
     return true;
 }
 
-void DirList::AddEntrie(const std::string &filepath, const char *filename, BOOL isDir) {
+void DirList::AddEntrie(std::vector<DirEntry> &list, const std::string &filepath, const char *filename, BOOL isDir) {
     if (!filename)
         return;
 
-    int32_t pos = FileInfo.size();
+    int32_t pos = list.size();
 
-    FileInfo.resize(pos + 1);
+    list.resize(pos + 1);
 
-    FileInfo[pos].FilePath = (char *) malloc(filepath.size() + strlen(filename) + 2);
-    if (!FileInfo[pos].FilePath) {
-        FileInfo.resize(pos);
+    list[pos].FilePath = (char *) malloc(filepath.size() + strlen(filename) + 2);
+    if (!list[pos].FilePath) {
+        list.resize(pos);
         return;
     }
 
-    sprintf(FileInfo[pos].FilePath, "%s/%s", filepath.c_str(), filename);
-    FileInfo[pos].isDir = isDir;
+    sprintf(list[pos].FilePath, "%s/%s", filepath.c_str(), filename);
+    list[pos].isDir = isDir;
 }
 
 void DirList::ClearList() {
@@ -196,13 +277,13 @@ void DirList::SortList(BOOL (*SortFunc)(const DirEntry &a, const DirEntry &b)) {
 }
 
 uint64_t DirList::GetFilesize(int32_t index) const {
-    struct stat st;
+    FSStatEntry entry;
     const char *path = GetFilepath(index);
 
-    if (!path || stat(path, &st) != 0)
+    if (!path || !FSStatCache::Stat(path, &entry))
         return 0;
 
-    return st.st_size;
+    return entry.size;
 }
 
 int32_t DirList::GetFileIndex(const char *filename) const {
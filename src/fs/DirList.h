@@ -96,14 +96,27 @@ public:
         Files           = 0x01,
         Dirs            = 0x02,
         CheckSubfolders = 0x08,
+        //! scan the sub folders of the given path on SCAN_WORKERS threads
+        ParallelScan = 0x10,
+        //! together with ParallelScan: append results as the workers finish instead of in serial scan order
+        UnorderedScan = 0x20,
     };
 
 protected:
     // Internal parser
-    BOOL InternalLoadPath(std::string &path);
+    BOOL InternalLoadPath(std::string &path, uint32_t depth, std::vector<DirEntry> &list) const;
+
+    // Internal parser which shares the sub folders of path between the workers
+    BOOL InternalLoadPathParallel(const std::string &path);
+
+    //! one per core of the console, including the calling thread
+    static constexpr uint32_t SCAN_WORKERS = 3;
+
+    //! Check the entry against the search flags and the extension filter
+    BOOL IsListed(const char *filename, BOOL isDir) const;
 
     //!Add a list entrie
-    void AddEntrie(const std::string &filepath, const char *filename, BOOL isDir);
+    static void AddEntrie(std::vector<DirEntry> &list, const std::string &filepath, const char *filename, BOOL isDir);
 
     //! Clear the list
     void ClearList();
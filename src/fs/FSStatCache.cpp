@@ -0,0 +1,114 @@
+#include "fs/FSStatCache.h"
+#include "fs/IFileSystem.h"
+#include "utils/logger.h"
+#include <sys/stat.h>
+
+std::mutex FSStatCache::mutex;
+uint32_t FSStatCache::capacity      = FSStatCache::DEFAULT_CAPACITY;
+uint32_t FSStatCache::generation    = 0;
+FSStatCacheStats FSStatCache::stats = {};
+std::list<FSStatCache::CacheItem> FSStatCache::lru;
+std::unordered_map<std::string, std::list<FSStatCache::CacheItem>::iterator> FSStatCache::entries;
+
+bool FSStatCache::Stat(const std::string &path, FSStatEntry *entry) {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    auto itr = entries.find(path);
+    if (itr != entries.end()) {
+        //! move to the front, it's the most recently used now
+        lru.splice(lru.begin(), lru, itr->second);
+        *entry = itr->second->second;
+        if (entry->exists) {
+            stats.hits++;
+        } else {
+            stats.negativeHits++;
+        }
+        return entry->exists;
+    }
+    stats.misses++;
+    uint32_t statGeneration = generation;
+    lock.unlock();
+
+    struct stat filestat;
+    FSStatEntry result = {};
+    if (IFileSystem::get()->stat(path.c_str(), &filestat) == 0) {
+        result.exists = true;
+        result.isDir  = S_ISDIR(filestat.st_mode);
+        result.size   = filestat.st_size;
+        result.mtime  = filestat.st_mtime;
+    }
+    *entry = result;
+
+    lock.lock();
+    //! another thread might have added it in the meantime, and a result from before an
+    //! invalidation may already be outdated
+    if (generation == statGeneration && entries.find(path) == entries.end() && capacity > 0) {
+        lru.emplace_front(path, result);
+        entries[path] = lru.begin();
+
+        while (entries.size() > capacity) {
+            entries.erase(lru.back().first);
+            lru.pop_back();
+            stats.evictions++;
+        }
+    }
+
+    return result.exists;
+}
+
+void FSStatCache::InvalidateLocked(const std::string &path) {
+    auto itr = entries.find(path);
+    if (itr != entries.end()) {
+        lru.erase(itr->second);
+        entries.erase(itr);
+        stats.invalidations++;
+    }
+}
+
+void FSStatCache::Invalidate(const std::string &path) {
+    std::string normalized(path);
+    while (normalized.size() > 1 && normalized[normalized.size() - 1] == '/')
+        normalized.erase(normalized.size() - 1);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    generation++;
+    InvalidateLocked(normalized);
+
+    std::string::size_type pos = normalized.rfind('/');
+    if (pos != std::string::npos) {
+        InvalidateLocked(normalized.substr(0, pos));
+        //! device roots are cached with a trailing slash
+        InvalidateLocked(normalized.substr(0, pos + 1));
+    }
+}
+
+void FSStatCache::InvalidateAll() {
+    std::lock_guard<std::mutex> lock(mutex);
+    generation++;
+    stats.invalidations += entries.size();
+    entries.clear();
+    lru.clear();
+}
+
+void FSStatCache::SetCapacity(uint32_t newCapacity) {
+    std::lock_guard<std::mutex> lock(mutex);
+    capacity = newCapacity;
+    while (entries.size() > capacity) {
+        entries.erase(lru.back().first);
+        lru.pop_back();
+        stats.evictions++;
+    }
+}
+
+FSStatCacheStats FSStatCache::GetStats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+void FSStatCache::LogStats() {
+    FSStatCacheStats cur = GetStats();
+    uint32_t lookups     = cur.hits + cur.negativeHits + cur.misses;
+    DEBUG_FUNCTION_LINE("stat cache: %u lookups, %u hits, %u negative hits, %u misses (%u%% hit rate), %u evictions, %u invalidations",
+                        lookups, cur.hits, cur.negativeHits, cur.misses, lookups ? ((cur.hits + cur.negativeHits) * 100) / lookups : 0,
+                        cur.evictions, cur.invalidations);
+}
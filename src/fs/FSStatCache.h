@@ -0,0 +1,60 @@
+#ifndef __FS_STAT_CACHE_H_
+#define __FS_STAT_CACHE_H_
+
+#include <list>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <time.h>
+#include <unordered_map>
+
+typedef struct {
+    bool exists;
+    bool isDir;
+    uint64_t size;
+    time_t mtime;
+} FSStatEntry;
+
+typedef struct {
+    uint32_t hits;
+    uint32_t negativeHits;
+    uint32_t misses;
+    uint32_t evictions;
+    uint32_t invalidations;
+} FSStatCacheStats;
+
+//! Small LRU cache of stat() results, including paths that do not exist.
+//! Everything that writes through FSUtils or CFile invalidates the affected paths.
+class FSStatCache {
+public:
+    static const uint32_t DEFAULT_CAPACITY = 256;
+
+    //! Fills entry with the cached or freshly stat'ed state of path, returns entry->exists
+    static bool Stat(const std::string &path, FSStatEntry *entry);
+
+    //! Drop path and its parent folder (which changes when an entry is created)
+    static void Invalidate(const std::string &path);
+
+    static void InvalidateAll();
+
+    static void SetCapacity(uint32_t capacity);
+
+    static FSStatCacheStats GetStats();
+
+    static void LogStats();
+
+private:
+    typedef std::pair<std::string, FSStatEntry> CacheItem;
+
+    static void InvalidateLocked(const std::string &path);
+
+    static std::mutex mutex;
+    static uint32_t capacity;
+    //! counts the invalidations, a stat() which raced with one is not cached
+    static uint32_t generation;
+    static FSStatCacheStats stats;
+    static std::list<CacheItem> lru;
+    static std::unordered_map<std::string, std::list<CacheItem>::iterator> entries;
+};
+
+#endif // __FS_STAT_CACHE_H_
@@ -1,10 +1,14 @@
 #include "fs/FSUtils.h"
 #include "fs/CFile.hpp"
+#include "fs/FSStatCache.h"
+#include "fs/IFileSystem.h"
 #include "utils/logger.h"
 #include <fcntl.h>
 #include <malloc.h>
 #include <stdio.h>
 #include <string.h>
+#include <string>
+#include <sys/stat.h>
 #include <unistd.h>
 
 int32_t FSUtils::LoadFileToMem(const char *filepath, uint8_t **inbuffer, uint32_t *size) {
@@ -13,16 +17,18 @@ int32_t FSUtils::LoadFileToMem(const char *filepath, uint8_t **inbuffer, uint32_
     if (size)
         *size = 0;
 
-    int32_t iFd = open(filepath, O_RDONLY);
+    IFileSystem *fs = IFileSystem::get();
+
+    int32_t iFd = fs->open(filepath, O_RDONLY);
     if (iFd < 0)
         return -1;
 
-    uint32_t filesize = lseek(iFd, 0, SEEK_END);
-    lseek(iFd, 0, SEEK_SET);
+    uint32_t filesize = fs->lseek(iFd, 0, SEEK_END);
+    fs->lseek(iFd, 0, SEEK_SET);
 
     uint8_t *buffer = (uint8_t *) malloc(filesize);
     if (buffer == nullptr) {
-        close(iFd);
+        fs->close(iFd);
         return -2;
     }
 
@@ -34,13 +40,13 @@ int32_t FSUtils::LoadFileToMem(const char *filepath, uint8_t **inbuffer, uint32_
         if (done + blocksize > filesize) {
             blocksize = filesize - done;
         }
-        readBytes = read(iFd, buffer + done, blocksize);
+        readBytes = fs->read(iFd, buffer + done, blocksize);
         if (readBytes <= 0)
             break;
         done += readBytes;
     }
 
-    close(iFd);
+    fs->close(iFd);
 
     if (done != filesize) {
         free(buffer);
@@ -62,20 +68,17 @@ int32_t FSUtils::CheckFile(const char *filepath) {
     if (!filepath)
         return 0;
 
-    struct stat filestat;
-
-    char dirnoslash[strlen(filepath) + 2];
-    snprintf(dirnoslash, sizeof(dirnoslash), "%s", filepath);
+    std::string dirnoslash(filepath);
 
-    while (dirnoslash[strlen(dirnoslash) - 1] == '/')
-        dirnoslash[strlen(dirnoslash) - 1] = '\0';
+    while (!dirnoslash.empty() && dirnoslash[dirnoslash.size() - 1] == '/')
+        dirnoslash.erase(dirnoslash.size() - 1);
 
-    char *notRoot = strrchr(dirnoslash, '/');
-    if (!notRoot) {
-        strcat(dirnoslash, "/");
+    if (dirnoslash.find('/') == std::string::npos) {
+        dirnoslash += '/';
     }
 
-    if (stat(dirnoslash, &filestat) == 0)
+    FSStatEntry entry;
+    if (FSStatCache::Stat(dirnoslash, &entry))
         return 1;
 
     return 0;
@@ -87,44 +90,35 @@ int32_t FSUtils::CreateSubfolder(const char *fullpath) {
 
     int32_t result = 0;
 
-    char dirnoslash[strlen(fullpath) + 1];
-    strcpy(dirnoslash, fullpath);
+    std::string dirnoslash(fullpath);
 
-    int32_t pos = strlen(dirnoslash) - 1;
-    while (dirnoslash[pos] == '/') {
-        dirnoslash[pos] = '\0';
-        pos--;
-    }
+    while (!dirnoslash.empty() && dirnoslash[dirnoslash.size() - 1] == '/')
+        dirnoslash.erase(dirnoslash.size() - 1);
 
-    if (CheckFile(dirnoslash)) {
+    if (CheckFile(dirnoslash.c_str())) {
         return 1;
     } else {
-        char parentpath[strlen(dirnoslash) + 2];
-        strcpy(parentpath, dirnoslash);
-        char *ptr = strrchr(parentpath, '/');
+        std::string::size_type pos = dirnoslash.rfind('/');
 
-        if (!ptr) {
+        if (pos == std::string::npos) {
             //!Device root directory (must be with '/')
-            strcat(parentpath, "/");
-            struct stat filestat;
-            if (stat(parentpath, &filestat) == 0)
-                return 1;
-
-            return 0;
+            return CheckFile(dirnoslash.c_str());
         }
 
-        ptr++;
-        ptr[0] = '\0';
-
-        result = CreateSubfolder(parentpath);
+        result = CreateSubfolder(dirnoslash.substr(0, pos + 1).c_str());
     }
 
     if (!result)
         return 0;
 
-    if (mkdir(dirnoslash, 0777) == -1) {
+    //! the negative entry from the check above is stale from here on, a check on another
+    //! thread may cache it again until the folder exists
+    FSStatCache::Invalidate(dirnoslash);
+
+    if (IFileSystem::get()->mkdir(dirnoslash.c_str(), 0777) == -1) {
         return 0;
     }
+    FSStatCache::Invalidate(dirnoslash);
 
     return 1;
 }
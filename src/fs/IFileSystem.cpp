@@ -0,0 +1,18 @@
+#include "fs/IFileSystem.h"
+#include "fs/FSStatCache.h"
+#include "fs/PosixFileSystem.h"
+
+IFileSystem *IFileSystem::current = nullptr;
+
+IFileSystem *IFileSystem::get() {
+    if (!current)
+        current = PosixFileSystem::instance();
+    return current;
+}
+
+void IFileSystem::set(IFileSystem *fs) {
+    current = fs ? fs : PosixFileSystem::instance();
+
+    //! cached results belong to the previous backend
+    FSStatCache::InvalidateAll();
+}
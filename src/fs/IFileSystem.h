@@ -0,0 +1,56 @@
+#ifndef __I_FILE_SYSTEM_H_
+#define __I_FILE_SYSTEM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <sys/stat.h>
+
+//! Backend for all file access of CFile, FSUtils and DirList.
+//! The default is the POSIX/devoptab implementation, other backends can be
+//! installed to run the load paths against a reproducible file system.
+class IFileSystem {
+public:
+    typedef struct {
+        std::string name;
+        bool isDir;
+    } DirItem;
+
+    virtual ~IFileSystem() {}
+
+    //! \param flags O_* flags as used by ::open
+    //! \return handle >= 0 on success
+    virtual int32_t open(const char *path, int32_t flags) = 0;
+
+    virtual int32_t read(int32_t fd, void *buffer, size_t size) = 0;
+
+    virtual int32_t write(int32_t fd, const void *buffer, size_t size) = 0;
+
+    virtual int64_t lseek(int32_t fd, int64_t offset, int32_t whence) = 0;
+
+    virtual int32_t close(int32_t fd) = 0;
+
+    virtual int32_t stat(const char *path, struct stat *st) = 0;
+
+    virtual int32_t mkdir(const char *path, mode_t mode) = 0;
+
+    //! \return directory handle or nullptr
+    virtual void *opendir(const char *path) = 0;
+
+    //! \return false when there are no more entries
+    virtual bool readdir(void *dir, DirItem *item) = 0;
+
+    virtual void closedir(void *dir) = 0;
+
+    //! The backend currently in use
+    static IFileSystem *get();
+
+    //! Replace the backend, nullptr restores the POSIX one. Ownership stays with the caller.
+    //! Must not be called while files of the old backend are still open.
+    static void set(IFileSystem *fs);
+
+private:
+    static IFileSystem *current;
+};
+
+#endif // __I_FILE_SYSTEM_H_
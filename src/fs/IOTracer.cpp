@@ -0,0 +1,233 @@
+#include "fs/IOTracer.h"
+#include "utils/logger.h"
+#include <fcntl.h>
+#include <string.h>
+
+IOTracer *IOTracer::instance = nullptr;
+
+IOTracer::IOTracer(IFileSystem *backend, uint32_t maxEvents)
+    : backend(backend), startTime(Clock::now()), events(maxEvents) {
+}
+
+void IOTracer::Start(uint32_t maxEvents) {
+    if (instance || maxEvents == 0)
+        return;
+
+    instance = new IOTracer(IFileSystem::get(), maxEvents);
+    IFileSystem::set(instance);
+    DEBUG_FUNCTION_LINE("Started I/O trace with room for %u events", maxEvents);
+}
+
+void IOTracer::Stop() {
+    if (!instance)
+        return;
+
+    IFileSystem::set(instance->backend);
+    //! files opened while tracing keep calling the tracer (CFile holds its backend),
+    //! so it is never deleted and only forwards to the backend from now on
+    instance->release();
+    instance = nullptr;
+}
+
+bool IOTracer::Dump(const char *path) {
+    if (!instance || !path)
+        return false;
+    return instance->dump(path);
+}
+
+void IOTracer::release() {
+    std::lock_guard<std::mutex> lock(mutex);
+    recording = false;
+    std::vector<Event>().swap(events);
+    std::vector<std::string>().swap(paths);
+    pathIds.clear();
+    openFiles.clear();
+    openDirs.clear();
+}
+
+uint16_t IOTracer::pathIndex(const char *path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!recording)
+        return 0xFFFF;
+    auto itr = pathIds.find(path);
+    if (itr != pathIds.end())
+        return itr->second;
+
+    //! index 0xFFFF marks paths which did not fit into the table anymore
+    if (paths.size() >= 0xFFFF)
+        return 0xFFFF;
+
+    uint16_t index = paths.size();
+    paths.emplace_back(path);
+    pathIds[paths.back()] = index;
+    return index;
+}
+
+void IOTracer::record(uint8_t type, Clock::time_point start, int32_t value, uint16_t path, uint16_t handle) {
+    Clock::time_point end = Clock::now();
+
+    Event event;
+    memset(&event, 0, sizeof(event));
+    event.time     = std::chrono::duration_cast<std::chrono::microseconds>(start - startTime).count();
+    event.duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    event.value    = value;
+    event.path     = path;
+    event.handle   = handle;
+    event.type     = type;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!recording)
+        return;
+    events[nextEvent] = event;
+    nextEvent         = (nextEvent + 1) % events.size();
+    recorded++;
+}
+
+void IOTracer::recordHandle(uint8_t type, Clock::time_point start, int32_t value, int32_t fd, bool release) {
+    OpenHandle handle = {0xFFFF, 0};
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto itr = openFiles.find(fd);
+        if (itr != openFiles.end()) {
+            handle = itr->second;
+            if (release)
+                openFiles.erase(itr);
+        }
+    }
+    record(type, start, value, handle.path, handle.handle);
+}
+
+int32_t IOTracer::open(const char *path, int32_t flags) {
+    Clock::time_point start = Clock::now();
+    int32_t fd              = backend->open(path, flags);
+    uint16_t pathId         = pathIndex(path);
+
+    uint16_t handle;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        handle = ++handleCounter;
+        if (fd >= 0 && recording)
+            openFiles[fd] = {pathId, handle};
+    }
+    //! a failed open is recorded with the negative result instead of the flags
+    record(EVENT_OPEN, start, fd >= 0 ? flags : fd, pathId, handle);
+    return fd;
+}
+
+int32_t IOTracer::read(int32_t fd, void *buffer, size_t size) {
+    Clock::time_point start = Clock::now();
+    int32_t result          = backend->read(fd, buffer, size);
+    recordHandle(EVENT_READ, start, result, fd, false);
+    return result;
+}
+
+int32_t IOTracer::write(int32_t fd, const void *buffer, size_t size) {
+    Clock::time_point start = Clock::now();
+    int32_t result          = backend->write(fd, buffer, size);
+    recordHandle(EVENT_WRITE, start, result, fd, false);
+    return result;
+}
+
+int64_t IOTracer::lseek(int32_t fd, int64_t offset, int32_t whence) {
+    Clock::time_point start = Clock::now();
+    int64_t result          = backend->lseek(fd, offset, whence);
+    recordHandle(EVENT_SEEK, start, (int32_t) result, fd, false);
+    return result;
+}
+
+int32_t IOTracer::close(int32_t fd) {
+    Clock::time_point start = Clock::now();
+    int32_t result          = backend->close(fd);
+    recordHandle(EVENT_CLOSE, start, result, fd, true);
+    return result;
+}
+
+int32_t IOTracer::stat(const char *path, struct stat *st) {
+    Clock::time_point start = Clock::now();
+    int32_t result          = backend->stat(path, st);
+    record(EVENT_STAT, start, result == 0 ? (int32_t) st->st_size : result, pathIndex(path), 0);
+    return result;
+}
+
+int32_t IOTracer::mkdir(const char *path, mode_t mode) {
+    Clock::time_point start = Clock::now();
+    int32_t result          = backend->mkdir(path, mode);
+    record(EVENT_MKDIR, start, result, pathIndex(path), 0);
+    return result;
+}
+
+void *IOTracer::opendir(const char *path) {
+    Clock::time_point start = Clock::now();
+    void *dir               = backend->opendir(path);
+    uint16_t pathId         = pathIndex(path);
+
+    uint16_t handle;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        handle = ++handleCounter;
+        if (dir && recording)
+            openDirs[dir] = {pathId, handle};
+    }
+    record(EVENT_OPENDIR, start, dir ? 0 : -1, pathId, handle);
+    return dir;
+}
+
+bool IOTracer::readdir(void *dir, DirItem *item) {
+    //! not recorded, the entries are implied by the listing on the host
+    return backend->readdir(dir, item);
+}
+
+void IOTracer::closedir(void *dir) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        openDirs.erase(dir);
+    }
+    backend->closedir(dir);
+}
+
+bool IOTracer::dump(const char *path) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    //! write through the traced backend so the dump does not show up in the trace
+    int32_t fd = backend->open(path, O_TRUNC | O_CREAT | O_WRONLY);
+    if (fd < 0) {
+        DEBUG_FUNCTION_LINE("Failed to open %s", path);
+        return false;
+    }
+
+    uint32_t count     = recorded < events.size() ? recorded : events.size();
+    uint32_t header[6] = {
+            0x4C494F54, // "LIOT"
+            0x01020304, // byte order marker
+            1,          // version
+            count,
+            recorded - count, // events lost to the ring buffer
+            (uint32_t) paths.size(),
+    };
+
+    std::vector<uint8_t> out((uint8_t *) header, (uint8_t *) header + sizeof(header));
+    for (auto const &x : paths) {
+        uint16_t length = x.size();
+        out.insert(out.end(), (uint8_t *) &length, (uint8_t *) &length + sizeof(length));
+        out.insert(out.end(), x.begin(), x.end());
+    }
+
+    //! oldest event first
+    uint32_t first = (recorded < events.size()) ? 0 : nextEvent;
+    for (uint32_t i = 0; i < count; i++) {
+        const Event &event = events[(first + i) % events.size()];
+        out.insert(out.end(), (const uint8_t *) &event, (const uint8_t *) &event + sizeof(Event));
+    }
+
+    uint32_t done = 0;
+    while (done < out.size()) {
+        int32_t ret = backend->write(fd, out.data() + done, out.size() - done);
+        if (ret <= 0)
+            break;
+        done += ret;
+    }
+    backend->close(fd);
+
+    DEBUG_FUNCTION_LINE("Dumped %u of %u I/O events (%u paths) to %s", count, recorded, paths.size(), path);
+    return done == out.size();
+}
@@ -0,0 +1,114 @@
+#ifndef __IO_TRACER_H_
+#define __IO_TRACER_H_
+
+#include "fs/IFileSystem.h"
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+//! Opt-in recorder of every file system call. It sits in front of the active backend
+//! and keeps the calls in a fixed size ring buffer which can be dumped to a file.
+//! The dump is read by tools/iotrace.py (summary and replay on a host).
+class IOTracer : public IFileSystem {
+public:
+    enum EventTypes {
+        EVENT_OPEN    = 1,
+        EVENT_READ    = 2,
+        EVENT_WRITE   = 3,
+        EVENT_SEEK    = 4,
+        EVENT_CLOSE   = 5,
+        EVENT_STAT    = 6,
+        EVENT_MKDIR   = 7,
+        EVENT_OPENDIR = 8,
+    };
+
+    //! 20 bytes per event, written as is (big endian on the console)
+    typedef struct {
+        uint32_t time;     // us since the trace was started
+        uint32_t duration; // us spent in the backend
+        int32_t value;     // open: flags, read/write: bytes, seek: new offset, others: result
+        uint16_t path;     // index into the path table
+        uint16_t handle;   // number of the open/opendir this call belongs to
+        uint8_t type;
+        uint8_t reserved[3];
+    } Event;
+
+    static const uint32_t DEFAULT_EVENT_COUNT = 16384;
+
+    //! Start recording the calls of the currently installed backend
+    static void Start(uint32_t maxEvents = DEFAULT_EVENT_COUNT);
+
+    //! Restore the traced backend and drop the recording. The tracer itself stays alive
+    //! for the files which were opened through it.
+    static void Stop();
+
+    static bool IsActive() {
+        return instance != nullptr;
+    }
+
+    //! Write the recording to path (bypassing the tracer itself)
+    static bool Dump(const char *path);
+
+    int32_t open(const char *path, int32_t flags) override;
+
+    int32_t read(int32_t fd, void *buffer, size_t size) override;
+
+    int32_t write(int32_t fd, const void *buffer, size_t size) override;
+
+    int64_t lseek(int32_t fd, int64_t offset, int32_t whence) override;
+
+    int32_t close(int32_t fd) override;
+
+    int32_t stat(const char *path, struct stat *st) override;
+
+    int32_t mkdir(const char *path, mode_t mode) override;
+
+    void *opendir(const char *path) override;
+
+    bool readdir(void *dir, DirItem *item) override;
+
+    void closedir(void *dir) override;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    typedef struct {
+        uint16_t path;
+        uint16_t handle;
+    } OpenHandle;
+
+    IOTracer(IFileSystem *backend, uint32_t maxEvents);
+
+    ~IOTracer() override {}
+
+    //! Stops recording and frees the recording
+    void release();
+
+    uint16_t pathIndex(const char *path);
+
+    void record(uint8_t type, Clock::time_point start, int32_t value, uint16_t path, uint16_t handle);
+
+    void recordHandle(uint8_t type, Clock::time_point start, int32_t value, int32_t fd, bool release);
+
+    bool dump(const char *path);
+
+    static IOTracer *instance;
+
+    IFileSystem *backend;
+    Clock::time_point startTime;
+
+    std::mutex mutex;
+    bool recording = true;
+    std::vector<Event> events;
+    uint32_t nextEvent     = 0;
+    uint32_t recorded      = 0;
+    uint16_t handleCounter = 0;
+    std::vector<std::string> paths;
+    std::unordered_map<std::string, uint16_t> pathIds;
+    std::map<int32_t, OpenHandle> openFiles;
+    std::map<void *, OpenHandle> openDirs;
+};
+
+#endif // __IO_TRACER_H_
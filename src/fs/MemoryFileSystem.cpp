@@ -0,0 +1,229 @@
+#include "fs/MemoryFileSystem.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <utils/StringTools.h>
+
+std::string MemoryFileSystem::normalize(const std::string &path) {
+    std::string result(path);
+    StringTools::RemoveDoubleSlashs(result);
+    while (!result.empty() && result[result.size() - 1] == '/')
+        result.erase(result.size() - 1);
+    return result;
+}
+
+void MemoryFileSystem::addParentsLocked(const std::string &path) {
+    std::string::size_type pos = path.rfind('/');
+    while (pos != std::string::npos && pos > 0) {
+        std::string parent = path.substr(0, pos);
+        if (!directories.insert(parent).second)
+            break;
+        pos = parent.rfind('/');
+    }
+    //! device root, e.g. "fs:"
+    if (pos == std::string::npos) {
+        std::string::size_type colon = path.find(':');
+        if (colon != std::string::npos)
+            directories.insert(path.substr(0, colon + 1));
+    }
+}
+
+void MemoryFileSystem::addFile(const std::string &path, const uint8_t *data, size_t size) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string normalized = normalize(path);
+    files[normalized]      = std::make_shared<std::vector<uint8_t>>(data, data + size);
+    addParentsLocked(normalized);
+}
+
+void MemoryFileSystem::addDirectory(const std::string &path) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string normalized = normalize(path);
+    directories.insert(normalized);
+    addParentsLocked(normalized);
+}
+
+void MemoryFileSystem::clear() {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    files.clear();
+    directories.clear();
+    openFiles.clear();
+}
+
+int32_t MemoryFileSystem::open(const char *path, int32_t flags) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string normalized = normalize(path);
+
+    auto itr = files.find(normalized);
+    if (itr == files.end()) {
+        if (!(flags & O_CREAT)) {
+            errno = ENOENT;
+            return -1;
+        }
+        addParentsLocked(normalized);
+        itr = files.emplace(normalized, std::make_shared<std::vector<uint8_t>>()).first;
+    } else if (flags & O_TRUNC) {
+        itr->second->clear();
+    }
+
+    int32_t fd    = nextHandle++;
+    openFiles[fd] = {itr->second, 0, flags};
+    return fd;
+}
+
+int32_t MemoryFileSystem::read(int32_t fd, void *buffer, size_t size) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto itr = openFiles.find(fd);
+    if (itr == openFiles.end() || (itr->second.flags & O_ACCMODE) == O_WRONLY) {
+        errno = EBADF;
+        return -1;
+    }
+
+    OpenFile &file = itr->second;
+    if (file.pos >= file.data->size())
+        return 0;
+
+    size_t readSize = file.data->size() - file.pos;
+    if (readSize > size)
+        readSize = size;
+
+    memcpy(buffer, file.data->data() + file.pos, readSize);
+    file.pos += readSize;
+    return readSize;
+}
+
+int32_t MemoryFileSystem::write(int32_t fd, const void *buffer, size_t size) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto itr = openFiles.find(fd);
+    if (itr == openFiles.end() || (itr->second.flags & O_ACCMODE) == O_RDONLY) {
+        errno = EBADF;
+        return -1;
+    }
+
+    OpenFile &file = itr->second;
+    if (file.flags & O_APPEND)
+        file.pos = file.data->size();
+
+    if (file.pos + size > file.data->size())
+        file.data->resize(file.pos + size);
+
+    memcpy(file.data->data() + file.pos, buffer, size);
+    file.pos += size;
+    return size;
+}
+
+int64_t MemoryFileSystem::lseek(int32_t fd, int64_t offset, int32_t whence) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto itr = openFiles.find(fd);
+    if (itr == openFiles.end()) {
+        errno = EBADF;
+        return -1;
+    }
+
+    OpenFile &file = itr->second;
+    int64_t newPos = offset;
+    if (whence == SEEK_CUR) {
+        newPos += file.pos;
+    } else if (whence == SEEK_END) {
+        newPos += file.data->size();
+    }
+
+    if (newPos < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    file.pos = newPos;
+    return newPos;
+}
+
+int32_t MemoryFileSystem::close(int32_t fd) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (openFiles.erase(fd) == 0) {
+        errno = EBADF;
+        return -1;
+    }
+    return 0;
+}
+
+int32_t MemoryFileSystem::stat(const char *path, struct stat *st) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string normalized = normalize(path);
+
+    memset(st, 0, sizeof(struct stat));
+
+    auto itr = files.find(normalized);
+    if (itr != files.end()) {
+        st->st_mode = S_IFREG | 0666;
+        st->st_size = itr->second->size();
+        return 0;
+    }
+    if (directories.count(normalized)) {
+        st->st_mode = S_IFDIR | 0777;
+        return 0;
+    }
+
+    errno = ENOENT;
+    return -1;
+}
+
+int32_t MemoryFileSystem::mkdir(const char *path, mode_t mode) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string normalized = normalize(path);
+
+    if (directories.count(normalized) || files.count(normalized)) {
+        errno = EEXIST;
+        return -1;
+    }
+
+    std::string::size_type pos = normalized.rfind('/');
+    if (pos != std::string::npos && !directories.count(normalized.substr(0, pos)) && !directories.count(normalized.substr(0, pos + 1))) {
+        errno = ENOENT;
+        return -1;
+    }
+
+    directories.insert(normalized);
+    return 0;
+}
+
+void *MemoryFileSystem::opendir(const char *path) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    std::string normalized = normalize(path);
+
+    if (!directories.count(normalized)) {
+        errno = ENOENT;
+        return nullptr;
+    }
+
+    auto *dir = new OpenDir;
+    dir->pos  = 0;
+    dir->items.push_back({".", true});
+    dir->items.push_back({"..", true});
+
+    std::string prefix = normalized + "/";
+    for (auto const &x : directories) {
+        if (x.size() > prefix.size() && x.compare(0, prefix.size(), prefix) == 0 && x.find('/', prefix.size()) == std::string::npos) {
+            dir->items.push_back({x.substr(prefix.size()), true});
+        }
+    }
+    for (auto const &x : files) {
+        if (x.first.size() > prefix.size() && x.first.compare(0, prefix.size(), prefix) == 0 && x.first.find('/', prefix.size()) == std::string::npos) {
+            dir->items.push_back({x.first.substr(prefix.size()), false});
+        }
+    }
+
+    return dir;
+}
+
+bool MemoryFileSystem::readdir(void *dir, DirItem *item) {
+    auto *openDir = (OpenDir *) dir;
+    if (!openDir || openDir->pos >= openDir->items.size())
+        return false;
+
+    *item = openDir->items[openDir->pos++];
+    return true;
+}
+
+void MemoryFileSystem::closedir(void *dir) {
+    delete (OpenDir *) dir;
+}
@@ -0,0 +1,71 @@
+#ifndef __MEMORY_FILE_SYSTEM_H_
+#define __MEMORY_FILE_SYSTEM_H_
+
+#include "fs/IFileSystem.h"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+//! File system which lives completely in memory. Used to run the load paths
+//! against a fixed set of files without touching any real device.
+class MemoryFileSystem : public IFileSystem {
+public:
+    MemoryFileSystem() {}
+
+    ~MemoryFileSystem() override {}
+
+    //! Add or replace a file, missing parent folders are created
+    void addFile(const std::string &path, const uint8_t *data, size_t size);
+
+    void addDirectory(const std::string &path);
+
+    void clear();
+
+    int32_t open(const char *path, int32_t flags) override;
+
+    int32_t read(int32_t fd, void *buffer, size_t size) override;
+
+    int32_t write(int32_t fd, const void *buffer, size_t size) override;
+
+    int64_t lseek(int32_t fd, int64_t offset, int32_t whence) override;
+
+    int32_t close(int32_t fd) override;
+
+    int32_t stat(const char *path, struct stat *st) override;
+
+    int32_t mkdir(const char *path, mode_t mode) override;
+
+    void *opendir(const char *path) override;
+
+    bool readdir(void *dir, DirItem *item) override;
+
+    void closedir(void *dir) override;
+
+private:
+    typedef std::shared_ptr<std::vector<uint8_t>> FileData;
+
+    typedef struct {
+        FileData data;
+        uint64_t pos;
+        int32_t flags;
+    } OpenFile;
+
+    typedef struct {
+        std::vector<DirItem> items;
+        size_t pos;
+    } OpenDir;
+
+    static std::string normalize(const std::string &path);
+
+    void addParentsLocked(const std::string &path);
+
+    std::recursive_mutex mutex;
+    std::map<std::string, FileData> files;
+    std::set<std::string> directories;
+    std::map<int32_t, OpenFile> openFiles;
+    int32_t nextHandle = 3;
+};
+
+#endif // __MEMORY_FILE_SYSTEM_H_
@@ -0,0 +1,51 @@
+#include "fs/PosixFileSystem.h"
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+int32_t PosixFileSystem::open(const char *path, int32_t flags) {
+    return ::open(path, flags);
+}
+
+int32_t PosixFileSystem::read(int32_t fd, void *buffer, size_t size) {
+    return ::read(fd, buffer, size);
+}
+
+int32_t PosixFileSystem::write(int32_t fd, const void *buffer, size_t size) {
+    return ::write(fd, buffer, size);
+}
+
+int64_t PosixFileSystem::lseek(int32_t fd, int64_t offset, int32_t whence) {
+    return ::lseek(fd, offset, whence);
+}
+
+int32_t PosixFileSystem::close(int32_t fd) {
+    return ::close(fd);
+}
+
+int32_t PosixFileSystem::stat(const char *path, struct stat *st) {
+    return ::stat(path, st);
+}
+
+int32_t PosixFileSystem::mkdir(const char *path, mode_t mode) {
+    return ::mkdir(path, mode);
+}
+
+void *PosixFileSystem::opendir(const char *path) {
+    return ::opendir(path);
+}
+
+bool PosixFileSystem::readdir(void *dir, DirItem *item) {
+    struct dirent *dirent = ::readdir((DIR *) dir);
+    if (dirent == nullptr)
+        return false;
+
+    item->name  = dirent->d_name;
+    item->isDir = (dirent->d_type & DT_DIR) != 0;
+    return true;
+}
+
+void PosixFileSystem::closedir(void *dir) {
+    ::closedir((DIR *) dir);
+}
@@ -0,0 +1,35 @@
+#ifndef __POSIX_FILE_SYSTEM_H_
+#define __POSIX_FILE_SYSTEM_H_
+
+#include "fs/IFileSystem.h"
+
+//! Direct calls into newlib, which ends up in the devoptab of wut (fs:/, sd: ...)
+class PosixFileSystem : public IFileSystem {
+public:
+    static PosixFileSystem *instance() {
+        static PosixFileSystem posixFileSystem;
+        return &posixFileSystem;
+    }
+
+    int32_t open(const char *path, int32_t flags) override;
+
+    int32_t read(int32_t fd, void *buffer, size_t size) override;
+
+    int32_t write(int32_t fd, const void *buffer, size_t size) override;
+
+    int64_t lseek(int32_t fd, int64_t offset, int32_t whence) override;
+
+    int32_t close(int32_t fd) override;
+
+    int32_t stat(const char *path, struct stat *st) override;
+
+    int32_t mkdir(const char *path, mode_t mode) override;
+
+    void *opendir(const char *path) override;
+
+    bool readdir(void *dir, DirItem *item) override;
+
+    void closedir(void *dir) override;
+};
+
+#endif // __POSIX_FILE_SYSTEM_H_
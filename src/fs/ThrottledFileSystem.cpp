@@ -0,0 +1,70 @@
+#include "fs/ThrottledFileSystem.h"
+#include <chrono>
+#include <thread>
+
+const ThrottledFileSystem::Profile ThrottledFileSystem::NAND    = {"NAND", 1500, 250, 0, 800, 20 * 1024 * 1024};
+const ThrottledFileSystem::Profile ThrottledFileSystem::USB_HDD = {"USB HDD", 6000, 1000, 8000, 3000, 30 * 1024 * 1024};
+const ThrottledFileSystem::Profile ThrottledFileSystem::SD      = {"SD", 2500, 600, 300, 1500, 10 * 1024 * 1024};
+
+void ThrottledFileSystem::delay(uint32_t latency, size_t bytes) {
+    uint64_t time = latency;
+    if (bytes > 0 && profile.bytesPerSecond > 0) {
+        time += ((uint64_t) bytes * 1000000ULL) / profile.bytesPerSecond;
+    }
+    if (time == 0)
+        return;
+
+    injectedDelay += time;
+    std::this_thread::sleep_for(std::chrono::microseconds(time));
+}
+
+int32_t ThrottledFileSystem::open(const char *path, int32_t flags) {
+    delay(profile.openLatency);
+    return backend->open(path, flags);
+}
+
+int32_t ThrottledFileSystem::read(int32_t fd, void *buffer, size_t size) {
+    int32_t result = backend->read(fd, buffer, size);
+    delay(profile.requestLatency, result > 0 ? result : 0);
+    return result;
+}
+
+int32_t ThrottledFileSystem::write(int32_t fd, const void *buffer, size_t size) {
+    int32_t result = backend->write(fd, buffer, size);
+    delay(profile.requestLatency, result > 0 ? result : 0);
+    return result;
+}
+
+int64_t ThrottledFileSystem::lseek(int32_t fd, int64_t offset, int32_t whence) {
+    delay(profile.seekLatency);
+    return backend->lseek(fd, offset, whence);
+}
+
+int32_t ThrottledFileSystem::close(int32_t fd) {
+    delay(profile.requestLatency);
+    return backend->close(fd);
+}
+
+int32_t ThrottledFileSystem::stat(const char *path, struct stat *st) {
+    delay(profile.metaLatency);
+    return backend->stat(path, st);
+}
+
+int32_t ThrottledFileSystem::mkdir(const char *path, mode_t mode) {
+    delay(profile.metaLatency);
+    return backend->mkdir(path, mode);
+}
+
+void *ThrottledFileSystem::opendir(const char *path) {
+    delay(profile.openLatency);
+    return backend->opendir(path);
+}
+
+bool ThrottledFileSystem::readdir(void *dir, DirItem *item) {
+    delay(profile.requestLatency);
+    return backend->readdir(dir, item);
+}
+
+void ThrottledFileSystem::closedir(void *dir) {
+    backend->closedir(dir);
+}
@@ -0,0 +1,69 @@
+#ifndef __THROTTLED_FILE_SYSTEM_H_
+#define __THROTTLED_FILE_SYSTEM_H_
+
+#include "fs/IFileSystem.h"
+#include <atomic>
+
+//! Wraps another backend and delays every call like a slow device would.
+//! Combined with the MemoryFileSystem this gives repeatable load times on any machine.
+class ThrottledFileSystem : public IFileSystem {
+public:
+    typedef struct {
+        const char *name;
+        //! fixed costs per call in microseconds
+        uint32_t openLatency;
+        uint32_t requestLatency;
+        uint32_t seekLatency;
+        uint32_t metaLatency;
+        //! transfer rate for read and write
+        uint32_t bytesPerSecond;
+    } Profile;
+
+    //! rough numbers of the storage devices a Wii U title can live on
+    static const Profile NAND;
+    static const Profile USB_HDD;
+    static const Profile SD;
+
+    ThrottledFileSystem(IFileSystem *backend, const Profile &profile)
+        : backend(backend), profile(profile) {}
+
+    ~ThrottledFileSystem() override {}
+
+    const Profile &getProfile() const {
+        return profile;
+    }
+
+    //! sum of all injected delays since creation in microseconds
+    uint64_t getInjectedDelay() const {
+        return injectedDelay;
+    }
+
+    int32_t open(const char *path, int32_t flags) override;
+
+    int32_t read(int32_t fd, void *buffer, size_t size) override;
+
+    int32_t write(int32_t fd, const void *buffer, size_t size) override;
+
+    int64_t lseek(int32_t fd, int64_t offset, int32_t whence) override;
+
+    int32_t close(int32_t fd) override;
+
+    int32_t stat(const char *path, struct stat *st) override;
+
+    int32_t mkdir(const char *path, mode_t mode) override;
+
+    void *opendir(const char *path) override;
+
+    bool readdir(void *dir, DirItem *item) override;
+
+    void closedir(void *dir) override;
+
+private:
+    void delay(uint32_t latency, size_t bytes = 0);
+
+    IFileSystem *backend;
+    Profile profile;
+    std::atomic<uint64_t> injectedDelay{0};
+};
+
+#endif // __THROTTLED_FILE_SYSTEM_H_
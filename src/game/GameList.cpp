@@ -3,12 +3,14 @@
 #include <coreinit/mcp.h>
 #include <nn/acp/nn_acp_types.h>
 #include <nn/acp/title.h>
+#include <map>
 #include <string.h>
 #include <string>
 
 #include "GameList.h"
 #include "common/common.h"
 #include "utils/AsyncExecutor.h"
+#include "utils/MemoryAccounting.h"
 
 #include "fs/FSUtils.h"
 #include "utils/logger.h"
@@ -19,14 +21,42 @@ GameList::GameList() {
 GameList::~GameList() {
     stopAsyncLoading = true;
     DCFlushRange(&stopAsyncLoading, sizeof(stopAsyncLoading));
+    //! the tasks use the titles without the lock, they are deleted once the last one returned
+    std::unique_lock<std::mutex> tasks(tasksLock);
+    tasksDone.wait(tasks, [this] { return runningTasks == 0; });
+    tasks.unlock();
     clear();
 };
 
+void GameList::executeTask(std::function<void()> func) {
+    tasksLock.lock();
+    DCFlushRange(&stopAsyncLoading, sizeof(stopAsyncLoading));
+    if (stopAsyncLoading) {
+        tasksLock.unlock();
+        return;
+    }
+    runningTasks++;
+    tasksLock.unlock();
+
+    AsyncExecutor::execute([this, func] {
+        func();
+        tasksLock.lock();
+        runningTasks--;
+        tasksDone.notify_all();
+        tasksLock.unlock();
+    });
+}
+
+void GameList::loadAsync() {
+    executeTask([this] { load(); });
+}
+
 void GameList::clear() {
     lock();
     for (auto const &x : fullGameList) {
         if (x != nullptr) {
             if (x->imageData != nullptr) {
+                MemoryAccounting::Remove(MEMORY_TITLE_ICON, MemoryAccounting::GetTextureSize(x->imageData));
                 AsyncExecutor::pushForDelete(x->imageData);
                 x->imageData = nullptr;
             }
@@ -36,6 +66,24 @@ void GameList::clear() {
     fullGameList.clear();
     //! Clear memory of the vector completely
     std::vector<gameInfo *>().swap(fullGameList);
+    for (auto const &x : retiredTitles) {
+        if (x->imageData != nullptr) {
+            MemoryAccounting::Remove(MEMORY_TITLE_ICON, MemoryAccounting::GetTextureSize(x->imageData));
+            AsyncExecutor::pushForDelete(x->imageData);
+        }
+        delete x;
+    }
+    retiredTitles.clear();
+    evictedLock.lock();
+    for (auto const &x : evictedImageData) {
+        AsyncExecutor::pushForDelete(x);
+    }
+    evictedImageData.clear();
+    evictedLock.unlock();
+    sortOrder.clear();
+    searchIndex.clear();
+    loadedIcons.clear();
+    restoredTitles = false;
     unlock();
     titleListChanged(this);
 }
@@ -54,15 +102,6 @@ gameInfo *GameList::getGameInfo(uint64_t titleId) {
 }
 
 int32_t GameList::readGameList() {
-    // Clear list
-    for (auto const &x : fullGameList) {
-        delete x;
-    }
-
-    fullGameList.clear();
-    //! Clear memory of the vector completely
-    std::vector<gameInfo *>().swap(fullGameList);
-
     int32_t cnt = 0;
 
     MCPError mcp = MCP_Open();
@@ -106,56 +145,73 @@ int32_t GameList::readGameList() {
         titles.resize(realTitleCount);
     }
 
+    //! titles restored from the session snapshot are shown already, they keep their infos and icons
+    std::map<uint64_t, gameInfo *> restored;
+    for (auto const &x : fullGameList) {
+        restored[x->titleId] = x;
+    }
+
+    fullGameList.clear();
+    //! Clear memory of the vector completely
+    std::vector<gameInfo *>().swap(fullGameList);
+    sortOrder.clear();
+    searchIndex.clear();
+
     for (auto title_candidate : titles) {
-        auto *newGameInfo      = new gameInfo;
-        newGameInfo->titleId   = title_candidate.titleId;
-        newGameInfo->appType   = title_candidate.appType;
-        newGameInfo->gamePath  = title_candidate.path;
-        newGameInfo->name      = "<unknown>";
-        newGameInfo->imageData = nullptr;
+        gameInfo *newGameInfo = nullptr;
+        auto itr              = restored.find(title_candidate.titleId);
+        if (itr != restored.end()) {
+            newGameInfo = itr->second;
+            restored.erase(itr);
+        } else {
+            newGameInfo            = new gameInfo;
+            newGameInfo->titleId   = title_candidate.titleId;
+            newGameInfo->name      = "<unknown>";
+            newGameInfo->imageData = nullptr;
+        }
+        newGameInfo->appType  = title_candidate.appType;
+        newGameInfo->gamePath = title_candidate.path;
         DCFlushRange(newGameInfo, sizeof(gameInfo));
 
         fullGameList.push_back(newGameInfo);
+        sortOrder.insert(newGameInfo->titleId, newGameInfo->appType, newGameInfo->name);
+        searchIndex.insert(newGameInfo->titleId, newGameInfo->name);
         titleAdded(newGameInfo);
         cnt++;
     }
 
-    AsyncExecutor::execute([this] {
-        lock();
-        for (auto header : fullGameList) {
+    //! restored titles which are not installed anymore are shown until titleListChanged reaches the views
+    for (auto const &x : restored) {
+        retiredTitles.push_back(x.second);
+    }
+    restoredTitles = false;
+
+    //! the files are read without the lock, so the icons requested by prefetchIcons() are loaded in between
+    executeTask([this] {
+        for (uint32_t i = 0;; i++) {
             DCFlushRange(&stopAsyncLoading, sizeof(stopAsyncLoading));
             if (stopAsyncLoading) {
                 DEBUG_FUNCTION_LINE("Stop async title loading");
                 break;
             }
 
-            DEBUG_FUNCTION_LINE("Load extra infos of %016llX", header->titleId);
-            auto *meta = (ACPMetaXml *) calloc(1, 0x4000); //TODO fix wut
-            if (meta) {
-                auto acp = ACPGetTitleMetaXml(header->titleId, meta);
-                if (acp >= 0) {
-                    header->name = meta->shortname_en;
-                }
-                free(meta);
+            lock();
+            if (i >= fullGameList.size()) {
+                unlock();
+                break;
             }
+            gameInfo *header = fullGameList[i];
+            unlock();
 
-            if (header->imageData == nullptr) {
-                std::string filepath = "fs:" + header->gamePath + META_PATH + "/iconTex.tga";
-                uint8_t *buffer      = nullptr;
-                uint32_t bufferSize  = 0;
-                int iResult          = FSUtils::LoadFileToMem(filepath.c_str(), &buffer, &bufferSize);
-                if (iResult > 0) {
-                    auto *imageData   = new GuiImageData(buffer, bufferSize, GX2_TEX_CLAMP_MODE_MIRROR);
-                    header->imageData = imageData;
-
-                    //! free original image buffer which is converted to texture now and not needed anymore
-                    free(buffer);
-                }
+            DEBUG_FUNCTION_LINE("Load extra infos of %016llX", header->titleId);
+            loadTitleMeta(header);
+            //! the icons of the pages around the view are requested first, the others fill the budget
+            if (!isIconBudgetExceeded()) {
+                loadTitleIcon(header);
             }
             DCFlushRange(header, sizeof(gameInfo));
             titleUpdated(header);
         }
-        unlock();
     });
 
     return cnt;
@@ -163,36 +219,20 @@ int32_t GameList::readGameList() {
 
 void GameList::updateTitleInfo() {
     for (int i = 0; i < this->size(); i++) {
+        DCFlushRange(&stopAsyncLoading, sizeof(stopAsyncLoading));
+        if (stopAsyncLoading) {
+            break;
+        }
         gameInfo *newHeader = this->at(i);
 
         bool hasChanged = false;
 
         if (newHeader->name.empty()) {
-            auto *meta = (ACPMetaXml *) calloc(1, 0x4000); //TODO fix wut
-            if (meta) {
-                auto acp = ACPGetTitleMetaXml(newHeader->titleId, meta);
-                if (acp >= 0) {
-                    newHeader->name = meta->shortname_en;
-                    hasChanged      = true;
-                }
-                free(meta);
-            }
+            hasChanged = loadTitleMeta(newHeader);
         }
 
-        if (newHeader->imageData == nullptr) {
-            std::string filepath = "fs:" + newHeader->gamePath + META_PATH + "/iconTex.tga";
-            uint8_t *buffer      = nullptr;
-            uint32_t bufferSize  = 0;
-            int iResult          = FSUtils::LoadFileToMem(filepath.c_str(), &buffer, &bufferSize);
-
-            if (iResult > 0) {
-                auto *imageData      = new GuiImageData(buffer, bufferSize, GX2_TEX_CLAMP_MODE_MIRROR);
-                newHeader->imageData = imageData;
-                hasChanged           = true;
-
-                //! free original image buffer which is converted to texture now and not needed anymore
-                free(buffer);
-            }
+        if (!isIconBudgetExceeded()) {
+            hasChanged = loadTitleIcon(newHeader) || hasChanged;
         }
         if (hasChanged) {
             DCFlushRange(newHeader, sizeof(gameInfo));
@@ -201,13 +241,184 @@ void GameList::updateTitleInfo() {
     }
 }
 
+bool GameList::loadTitleMeta(gameInfo *info) {
+    bool res   = false;
+    auto *meta = (ACPMetaXml *) calloc(1, 0x4000); //TODO fix wut
+    if (meta) {
+        auto acp = ACPGetTitleMetaXml(info->titleId, meta);
+        if (acp >= 0) {
+            setTitleName(info, meta->shortname_en);
+            res = true;
+        }
+        free(meta);
+    }
+    return res;
+}
+
+bool GameList::loadTitleIcon(gameInfo *info) {
+    lock();
+    bool loaded          = (info->imageData != nullptr);
+    std::string filepath = "fs:" + info->gamePath + META_PATH + "/iconTex.tga";
+    unlock();
+    if (loaded) {
+        return false;
+    }
+
+    //! the file is read and converted without the lock, the GUI thread searches and launches meanwhile
+    uint8_t *buffer     = nullptr;
+    uint32_t bufferSize = 0;
+    int iResult         = FSUtils::LoadFileToMem(filepath.c_str(), &buffer, &bufferSize);
+    if (iResult <= 0) {
+        return false;
+    }
+
+    auto *imageData = new GuiImageData(buffer, bufferSize, GX2_TEX_CLAMP_MODE_MIRROR);
+    //! free original image buffer which is converted to texture now and not needed anymore
+    free(buffer);
+
+    //! the loading pass and the requests may both get to a title, the list may be cleared meanwhile
+    lock();
+    DCFlushRange(&stopAsyncLoading, sizeof(stopAsyncLoading));
+    if (stopAsyncLoading || info->imageData != nullptr) {
+        unlock();
+        //! never shown, so nothing draws it
+        delete imageData;
+        return false;
+    }
+    info->imageData = imageData;
+    loadedIcons.push_back(info->titleId);
+    MemoryAccounting::Add(MEMORY_TITLE_ICON, MemoryAccounting::GetTextureSize(imageData));
+    unlock();
+    return true;
+}
+
+bool GameList::isIconBudgetExceeded() {
+    uint32_t budget = MemoryAccounting::GetBudget(MEMORY_TITLE_ICON);
+    return budget != 0 && MemoryAccounting::GetLive(MEMORY_TITLE_ICON) >= budget;
+}
+
+void GameList::evictIcons(const std::vector<uint64_t> &keep) {
+    std::vector<gameInfo *> evicted;
+    std::vector<GuiImageData *> imageData;
+
+    lock();
+    uint32_t budget = MemoryAccounting::GetBudget(MEMORY_TITLE_ICON);
+    auto itr        = loadedIcons.begin();
+    while (budget != 0 && MemoryAccounting::GetLive(MEMORY_TITLE_ICON) > budget && itr != loadedIcons.end()) {
+        if (std::find(keep.begin(), keep.end(), *itr) != keep.end()) {
+            ++itr;
+            continue;
+        }
+        gameInfo *info = getGameInfo(*itr);
+        itr            = loadedIcons.erase(itr);
+        if (info == nullptr || info->imageData == nullptr) {
+            continue;
+        }
+
+        MemoryAccounting::Remove(MEMORY_TITLE_ICON, MemoryAccounting::GetTextureSize(info->imageData));
+        imageData.push_back(info->imageData);
+        evicted.push_back(info);
+        info->imageData = nullptr;
+        DCFlushRange(info, sizeof(gameInfo));
+        evictedIcons++;
+    }
+    unlock();
+
+    //! the views show the placeholder before the textures are handed to the GUI thread
+    for (auto const &info : evicted) {
+        titleUpdated(info);
+    }
+    if (!imageData.empty()) {
+        evictedLock.lock();
+        evictedImageData.insert(evictedImageData.end(), imageData.begin(), imageData.end());
+        evictedLock.unlock();
+    }
+}
+
+void GameList::takeEvictedIcons(std::vector<GuiImageData *> &out) {
+    evictedLock.lock();
+    out.swap(evictedImageData);
+    evictedLock.unlock();
+}
+
+void GameList::prefetchIcons(const std::vector<uint64_t> &titleIds) {
+    requestLock.lock();
+    iconRequests    = titleIds;
+    nextIconRequest = 0;
+    bool start      = !iconRequestsRunning && !iconRequests.empty();
+    if (start) {
+        iconRequestsRunning = true;
+    }
+    requestLock.unlock();
+
+    if (start) {
+        executeTask([this] { processIconRequests(); });
+    }
+}
+
+void GameList::processIconRequests() {
+    std::vector<uint64_t> keep;
+    while (true) {
+        requestLock.lock();
+        DCFlushRange(&stopAsyncLoading, sizeof(stopAsyncLoading));
+        if (stopAsyncLoading || nextIconRequest >= iconRequests.size()) {
+            iconRequestsRunning = false;
+            requestLock.unlock();
+            return;
+        }
+        //! a newer request replaces the list while this one is loading
+        uint64_t titleId = iconRequests[nextIconRequest++];
+        keep             = iconRequests;
+        requestLock.unlock();
+
+        gameInfo *info = getGameInfo(titleId);
+        if (info != nullptr && loadTitleIcon(info)) {
+            DCFlushRange(info, sizeof(gameInfo));
+            titleUpdated(info);
+            evictIcons(keep);
+        }
+    }
+}
+
+void GameList::setTitleName(gameInfo *info, const std::string &name) {
+    lock();
+    info->name = name;
+    sortOrder.rename(info->titleId, info->name);
+    searchIndex.rename(info->titleId, info->name);
+    unlock();
+}
+
+void GameList::restore(const SessionSnapshot &snapshot) {
+    lock();
+    if (!fullGameList.empty()) {
+        unlock();
+        return;
+    }
+    for (auto const &title : snapshot.titles) {
+        auto *info      = new gameInfo;
+        info->titleId   = title.titleId;
+        info->appType   = (MCPAppType) title.appType;
+        info->name      = title.name;
+        info->gamePath  = title.gamePath;
+        info->imageData = nullptr;
+        DCFlushRange(info, sizeof(gameInfo));
+
+        fullGameList.push_back(info);
+        sortOrder.insert(info->titleId, info->appType, info->name);
+        searchIndex.insert(info->titleId, info->name);
+        titleAdded(info);
+    }
+    restoredTitles = !fullGameList.empty();
+    unlock();
+}
+
 int32_t GameList::load() {
     lock();
-    if (fullGameList.empty()) {
+    if (fullGameList.empty() || restoredTitles) {
         readGameList();
     }
 
-    AsyncExecutor::execute([&] { updateTitleInfo(); });
+    executeTask([this] { updateTitleInfo(); });
 
     titleListChanged(this);
 
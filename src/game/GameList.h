@@ -1,9 +1,16 @@
 #ifndef GAME_LIST_H_
 #define GAME_LIST_H_
 
+#include "SessionSnapshot.h"
+#include "TitleSearchIndex.h"
+#include "TitleSortOrder.h"
 #include <coreinit/cache.h>
 #include <coreinit/mcp.h>
 #include <gui/GuiImageData.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <gui/sigslot.h>
 #include <mutex>
 #include <stdint.h>
@@ -61,8 +68,39 @@ public:
         return fullGameList;
     }
 
+    //! Titles in the order of key, kept sorted while the list changes. lock() while reading it.
+    const std::vector<const TitleSortOrder::Entry *> &getSortedGameList(TitleSortKey key) {
+        return sortOrder.get(key);
+    }
+
+    //! Titles whose name contains query, see TitleSearchIndex
+    void search(const std::string &query, std::vector<uint64_t> &out) {
+        lock();
+        searchIndex.search(query, out);
+        unlock();
+    }
+
     int32_t load();
 
+    //! Runs load() on the AsyncExecutor, the destructor waits for it
+    void loadAsync();
+
+    //! Adds the titles of the snapshot before load() enumerates all of them, the list has to be empty
+    void restore(const SessionSnapshot &snapshot);
+
+    //! Loads the icons of titleIds first, in this order. Replaces the titles requested before.
+    //! When the icons exceed the MEMORY_TITLE_ICON budget of MemoryAccounting, the ones loaded
+    //! first which are not requested are freed.
+    void prefetchIcons(const std::vector<uint64_t> &titleIds);
+
+    uint32_t getEvictedIconCount() const {
+        return evictedIcons;
+    }
+
+    //! Moves the textures of the icons evicted since the last call into out. No view shows them
+    //! anymore, the GUI thread deletes them once the GPU is done with the frames drawn before.
+    void takeEvictedIcons(std::vector<GuiImageData *> &out);
+
     sigslot::signal1<GameList *> titleListChanged;
     sigslot::signal1<gameInfo *> titleUpdated;
     sigslot::signal1<gameInfo *> titleAdded;
@@ -80,11 +118,49 @@ protected:
 
     void updateTitleInfo();
 
+    //! Renames the title and moves it in the sort orders
+    void setTitleName(gameInfo *info, const std::string &name);
+
+    bool loadTitleMeta(gameInfo *info);
+
+    bool loadTitleIcon(gameInfo *info);
+
+    bool isIconBudgetExceeded();
+
+    //! Frees the icons loaded first until the budget is met, titles in keep stay loaded
+    void evictIcons(const std::vector<uint64_t> &keep);
+
+    void processIconRequests();
+
+    //! Runs func on the AsyncExecutor unless the list is destroyed, the destructor waits for it
+    void executeTask(std::function<void()> func);
+
     std::vector<gameInfo *> fullGameList;
+    TitleSortOrder sortOrder;
+    TitleSearchIndex searchIndex;
 
     std::recursive_mutex _lock;
 
     bool stopAsyncLoading = false;
+    //! tasks started by executeTask() which did not return yet
+    std::mutex tasksLock;
+    std::condition_variable tasksDone;
+    uint32_t runningTasks = 0;
+
+    //! the list holds the titles of a session snapshot until it is enumerated
+    bool restoredTitles = false;
+    std::vector<gameInfo *> retiredTitles;
+
+    std::atomic<uint32_t> evictedIcons{0};
+    std::mutex evictedLock;
+    std::vector<GuiImageData *> evictedImageData;
+    //! titles with an icon in the order they were loaded, guarded by lock()
+    std::deque<uint64_t> loadedIcons;
+
+    std::mutex requestLock;
+    std::vector<uint64_t> iconRequests;
+    uint32_t nextIconRequest = 0;
+    bool iconRequestsRunning = false;
 };
 
 #endif
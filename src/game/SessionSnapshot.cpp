@@ -0,0 +1,119 @@
+#include "SessionSnapshot.h"
+#include "fs/FSUtils.h"
+#include "utils/logger.h"
+#include <stdlib.h>
+#include <string.h>
+
+template<typename T>
+static void Put(std::vector<uint8_t> &out, const T &value) {
+    const uint8_t *bytes = (const uint8_t *) &value;
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+static void PutString(std::vector<uint8_t> &out, const std::string &str) {
+    Put<uint32_t>(out, str.size());
+    out.insert(out.end(), str.begin(), str.end());
+}
+
+//! Reads the fields in order, every read past the end fails
+class SnapshotReader {
+public:
+    SnapshotReader(const uint8_t *data, uint32_t size) : data(data), size(size) {}
+
+    template<typename T>
+    bool get(T &value) {
+        if (size - pos < sizeof(T)) {
+            return false;
+        }
+        memcpy(&value, data + pos, sizeof(T));
+        pos += sizeof(T);
+        return true;
+    }
+
+    bool getString(std::string &str) {
+        uint32_t length = 0;
+        if (!get(length) || size - pos < length) {
+            return false;
+        }
+        str.assign((const char *) data + pos, length);
+        pos += length;
+        return true;
+    }
+
+    uint32_t remaining() const {
+        return size - pos;
+    }
+
+private:
+    const uint8_t *data;
+    uint32_t size;
+    uint32_t pos = 0;
+};
+
+bool SessionSnapshot::load(const char *path) {
+    uint8_t *buffer     = nullptr;
+    uint32_t bufferSize = 0;
+    if (FSUtils::LoadFileToMem(path, &buffer, &bufferSize) <= 0) {
+        return false;
+    }
+    bool res = decode(buffer, bufferSize);
+    free(buffer);
+    if (!res) {
+        DEBUG_FUNCTION_LINE("Ignoring invalid session snapshot %s", path);
+    }
+    return res;
+}
+
+bool SessionSnapshot::save(const char *path) const {
+    std::vector<uint8_t> data;
+    encode(data);
+    return FSUtils::saveBufferToFile(path, data.data(), data.size()) == (int32_t) data.size();
+}
+
+void SessionSnapshot::encode(std::vector<uint8_t> &out) const {
+    out.clear();
+    Put<uint32_t>(out, MAGIC);
+    Put<uint32_t>(out, VERSION);
+    Put<uint64_t>(out, selected);
+    Put<uint32_t>(out, page);
+    Put<uint32_t>(out, slots.size());
+    Put<uint32_t>(out, titles.size());
+    for (uint64_t id : slots) {
+        Put<uint64_t>(out, id);
+    }
+    for (auto const &title : titles) {
+        Put<uint64_t>(out, title.titleId);
+        Put<uint32_t>(out, title.appType);
+        PutString(out, title.name);
+        PutString(out, title.gamePath);
+    }
+}
+
+bool SessionSnapshot::decode(const uint8_t *data, uint32_t size) {
+    SnapshotReader reader(data, size);
+    uint32_t magic = 0, version = 0, slotCount = 0, titleCount = 0;
+    if (!reader.get(magic) || magic != MAGIC || !reader.get(version) || version != VERSION) {
+        return false;
+    }
+    if (!reader.get(selected) || !reader.get(page) || !reader.get(slotCount) || !reader.get(titleCount)) {
+        return false;
+    }
+    //! the counts are checked before anything is allocated for them
+    if (slotCount > reader.remaining() / sizeof(uint64_t)) {
+        return false;
+    }
+    slots.resize(slotCount);
+    for (auto &id : slots) {
+        reader.get(id);
+    }
+    if (titleCount > reader.remaining() / (sizeof(uint64_t) + 3 * sizeof(uint32_t))) {
+        return false;
+    }
+    titles.resize(titleCount);
+    for (auto &title : titles) {
+        if (!reader.get(title.titleId) || !reader.get(title.appType) || !reader.getString(title.name) || !reader.getString(title.gamePath)) {
+            return false;
+        }
+    }
+    return reader.remaining() == 0;
+}
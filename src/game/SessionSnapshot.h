@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+//! What the launcher showed when it started a title. It is read on the next start, so the
+//! page the user left is shown before the titles are enumerated again.
+class SessionSnapshot {
+public:
+    //! what is needed to show a title and load its icon without asking MCP and ACP
+    typedef struct {
+        uint64_t titleId;
+        uint32_t appType;
+        std::string name;
+        std::string gamePath;
+    } Title;
+
+    //! arranged order of the grid, 0 for empty slots
+    std::vector<uint64_t> slots;
+    uint64_t selected = 0;
+    uint32_t page     = 0;
+    //! the titles of page and the selected one
+    std::vector<Title> titles;
+
+    bool load(const char *path);
+
+    bool save(const char *path) const;
+
+    //! Written as is, the snapshot is only read by the console which wrote it
+    void encode(std::vector<uint8_t> &out) const;
+
+    //! False if data is not a complete snapshot of this version
+    bool decode(const uint8_t *data, uint32_t size);
+
+private:
+    static constexpr uint32_t MAGIC   = 0x4C534553; // "LSES"
+    static constexpr uint32_t VERSION = 1;
+};
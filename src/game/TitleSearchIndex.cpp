@@ -0,0 +1,146 @@
+#include "TitleSearchIndex.h"
+#include "TitleSortOrder.h"
+#include <algorithm>
+
+void TitleSearchIndex::insert(uint64_t titleId, const std::string &name) {
+    if (names.find(titleId) != names.end()) {
+        rename(titleId, name);
+        return;
+    }
+
+    std::string &folded = names[titleId];
+    folded              = TitleSortOrder::collationKey(name);
+    addKeys(titleId, folded);
+}
+
+void TitleSearchIndex::remove(uint64_t titleId) {
+    auto itr = names.find(titleId);
+    if (itr == names.end())
+        return;
+
+    removeKeys(titleId, itr->second);
+    names.erase(itr);
+}
+
+void TitleSearchIndex::rename(uint64_t titleId, const std::string &name) {
+    auto itr = names.find(titleId);
+    if (itr == names.end())
+        return;
+
+    std::string folded = TitleSortOrder::collationKey(name);
+    if (folded == itr->second)
+        return;
+
+    removeKeys(titleId, itr->second);
+    itr->second = std::move(folded);
+    addKeys(titleId, itr->second);
+}
+
+void TitleSearchIndex::clear() {
+    names.clear();
+    trigrams.clear();
+    words.clear();
+}
+
+void TitleSearchIndex::search(const std::string &query, std::vector<uint64_t> &out) const {
+    out.clear();
+    std::string folded = TitleSortOrder::collationKey(query);
+    if (folded.empty())
+        return;
+
+    if (folded.size() < 3) {
+        auto itr = std::lower_bound(words.begin(), words.end(), WordEntry(folded, 0));
+        for (; itr != words.end() && itr->first.compare(0, folded.size(), folded) == 0; ++itr) {
+            out.push_back(itr->second);
+        }
+        //! a title with two words starting alike is found twice
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+        return;
+    }
+
+    //! the rarest trigram of the query gives the fewest candidates to check
+    std::vector<uint32_t> keys;
+    getTrigrams(folded, keys);
+    const std::vector<uint64_t> *candidates = nullptr;
+    for (uint32_t key : keys) {
+        auto itr = trigrams.find(key);
+        if (itr == trigrams.end())
+            return;
+        if (candidates == nullptr || itr->second.size() < candidates->size())
+            candidates = &itr->second;
+    }
+
+    for (uint64_t titleId : *candidates) {
+        auto itr = names.find(titleId);
+        if (itr != names.end() && itr->second.find(folded) != std::string::npos)
+            out.push_back(titleId);
+    }
+}
+
+void TitleSearchIndex::getTrigrams(const std::string &folded, std::vector<uint32_t> &out) {
+    out.clear();
+    for (uint32_t i = 0; i + 3 <= folded.size(); i++) {
+        out.push_back(((uint8_t) folded[i] << 16) | ((uint8_t) folded[i + 1] << 8) | (uint8_t) folded[i + 2]);
+    }
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+void TitleSearchIndex::getWords(const std::string &folded, std::vector<std::string> &out) {
+    out.clear();
+    std::string word;
+    for (char c : folded) {
+        if (c == ' ' || c == '-' || c == ':' || c == '.' || c == ',') {
+            if (!word.empty())
+                out.push_back(word);
+            word.clear();
+        } else {
+            word += c;
+        }
+    }
+    if (!word.empty())
+        out.push_back(word);
+}
+
+void TitleSearchIndex::addKeys(uint64_t titleId, const std::string &folded) {
+    std::vector<uint32_t> keys;
+    getTrigrams(folded, keys);
+    for (uint32_t key : keys) {
+        trigrams[key].push_back(titleId);
+    }
+
+    std::vector<std::string> nameWords;
+    getWords(folded, nameWords);
+    for (auto &word : nameWords) {
+        WordEntry entry(std::move(word), titleId);
+        words.insert(std::upper_bound(words.begin(), words.end(), entry), std::move(entry));
+    }
+}
+
+void TitleSearchIndex::removeKeys(uint64_t titleId, const std::string &folded) {
+    std::vector<uint32_t> keys;
+    getTrigrams(folded, keys);
+    for (uint32_t key : keys) {
+        auto itr = trigrams.find(key);
+        if (itr == trigrams.end())
+            continue;
+        auto &titles = itr->second;
+        auto pos     = std::find(titles.begin(), titles.end(), titleId);
+        if (pos != titles.end()) {
+            //! the order of a posting list does not matter
+            *pos = titles.back();
+            titles.pop_back();
+        }
+        if (titles.empty())
+            trigrams.erase(itr);
+    }
+
+    std::vector<std::string> nameWords;
+    getWords(folded, nameWords);
+    for (auto &word : nameWords) {
+        auto pos = std::lower_bound(words.begin(), words.end(), WordEntry(word, titleId));
+        if (pos != words.end() && pos->first == word && pos->second == titleId)
+            words.erase(pos);
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+//! Finds titles by a part of their name while the user types. Names are case folded once
+//! when they change. Queries of three or more characters match anywhere in the name and
+//! are looked up by the trigrams of the query, shorter ones match the start of a word.
+class TitleSearchIndex {
+public:
+    //! Inserting a known title renames it
+    void insert(uint64_t titleId, const std::string &name);
+
+    void remove(uint64_t titleId);
+
+    void rename(uint64_t titleId, const std::string &name);
+
+    void clear();
+
+    //! Replaces out with the matching titles, an empty query matches nothing
+    void search(const std::string &query, std::vector<uint64_t> &out) const;
+
+private:
+    typedef std::pair<std::string, uint64_t> WordEntry;
+
+    static void getTrigrams(const std::string &folded, std::vector<uint32_t> &out);
+
+    static void getWords(const std::string &folded, std::vector<std::string> &out);
+
+    void addKeys(uint64_t titleId, const std::string &folded);
+
+    void removeKeys(uint64_t titleId, const std::string &folded);
+
+    //! folded name per title
+    std::unordered_map<uint64_t, std::string> names;
+    //! titles containing each trigram, three bytes packed into the key
+    std::unordered_map<uint32_t, std::vector<uint64_t>> trigrams;
+    //! every word of every name sorted, a prefix is a range found by binary search
+    std::vector<WordEntry> words;
+};
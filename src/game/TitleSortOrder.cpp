@@ -0,0 +1,102 @@
+#include "TitleSortOrder.h"
+#include <algorithm>
+
+void TitleSortOrder::insert(uint64_t titleId, uint32_t appType, const std::string &name) {
+    auto itr = entries.find(titleId);
+    if (itr != entries.end()) {
+        removeEntry(&itr->second);
+        itr->second.appType      = appType;
+        itr->second.collationKey = collationKey(name);
+        insertEntry(&itr->second);
+        return;
+    }
+
+    Entry &entry = entries[titleId];
+    entry        = {titleId, appType, collationKey(name)};
+    insertEntry(&entry);
+}
+
+void TitleSortOrder::remove(uint64_t titleId) {
+    auto itr = entries.find(titleId);
+    if (itr == entries.end())
+        return;
+
+    removeEntry(&itr->second);
+    entries.erase(itr);
+}
+
+void TitleSortOrder::rename(uint64_t titleId, const std::string &name) {
+    auto itr = entries.find(titleId);
+    if (itr == entries.end())
+        return;
+
+    std::string key = collationKey(name);
+    if (key == itr->second.collationKey)
+        return;
+
+    Entry *entry = &itr->second;
+    //! the title id order does not depend on the name
+    for (int32_t i = 0; i < SORT_KEY_COUNT; i++) {
+        if (i != SORT_BY_TITLE_ID)
+            removeFrom((TitleSortKey) i, entry);
+    }
+    entry->collationKey = std::move(key);
+    for (int32_t i = 0; i < SORT_KEY_COUNT; i++) {
+        if (i != SORT_BY_TITLE_ID)
+            insertInto((TitleSortKey) i, entry);
+    }
+}
+
+void TitleSortOrder::clear() {
+    for (auto &order : orders) {
+        order.clear();
+    }
+    entries.clear();
+}
+
+std::string TitleSortOrder::collationKey(const std::string &name) {
+    std::string key(name);
+    for (auto &c : key) {
+        if (c >= 'A' && c <= 'Z')
+            c += 'a' - 'A';
+    }
+    return key;
+}
+
+bool TitleSortOrder::less(TitleSortKey key, const Entry *a, const Entry *b) {
+    if (key == SORT_BY_APP_TYPE && a->appType != b->appType)
+        return a->appType < b->appType;
+
+    if (key != SORT_BY_TITLE_ID) {
+        int32_t res = a->collationKey.compare(b->collationKey);
+        if (res != 0)
+            return res < 0;
+    }
+    //! the title id keeps equal names in a stable order
+    return a->titleId < b->titleId;
+}
+
+void TitleSortOrder::insertEntry(const Entry *entry) {
+    for (int32_t i = 0; i < SORT_KEY_COUNT; i++) {
+        insertInto((TitleSortKey) i, entry);
+    }
+}
+
+void TitleSortOrder::removeEntry(const Entry *entry) {
+    for (int32_t i = 0; i < SORT_KEY_COUNT; i++) {
+        removeFrom((TitleSortKey) i, entry);
+    }
+}
+
+void TitleSortOrder::insertInto(TitleSortKey key, const Entry *entry) {
+    auto &order = orders[key];
+    auto pos    = std::upper_bound(order.begin(), order.end(), entry, [key](const Entry *a, const Entry *b) { return less(key, a, b); });
+    order.insert(pos, entry);
+}
+
+void TitleSortOrder::removeFrom(TitleSortKey key, const Entry *entry) {
+    auto &order = orders[key];
+    auto pos    = std::lower_bound(order.begin(), order.end(), entry, [key](const Entry *a, const Entry *b) { return less(key, a, b); });
+    if (pos != order.end() && *pos == entry)
+        order.erase(pos);
+}
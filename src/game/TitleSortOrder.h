@@ -0,0 +1,62 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+typedef enum _TitleSortKey {
+    SORT_BY_NAME,
+    SORT_BY_TITLE_ID,
+    //! grouped by app type, by name inside a group
+    SORT_BY_APP_TYPE,
+    SORT_KEY_COUNT
+} TitleSortKey;
+
+//! Titles sorted by each TitleSortKey. The orders are kept up to date on every insert,
+//! remove and rename, so reading one never sorts. Names are compared by a case folded
+//! key which is built once per rename instead of per comparison.
+class TitleSortOrder {
+public:
+    struct Entry {
+        uint64_t titleId;
+        uint32_t appType;
+        std::string collationKey;
+    };
+
+    //! Inserting a known title updates its keys
+    void insert(uint64_t titleId, uint32_t appType, const std::string &name);
+
+    void remove(uint64_t titleId);
+
+    void rename(uint64_t titleId, const std::string &name);
+
+    void clear();
+
+    uint32_t size() const {
+        return entries.size();
+    }
+
+    const std::vector<const Entry *> &get(TitleSortKey key) const {
+        return orders[key];
+    }
+
+    //! ASCII letters are folded to lower case, other bytes compare as they are
+    static std::string collationKey(const std::string &name);
+
+private:
+    static bool less(TitleSortKey key, const Entry *a, const Entry *b);
+
+    void insertEntry(const Entry *entry);
+
+    void removeEntry(const Entry *entry);
+
+    //! binary search, moving the pointers behind the position is the only linear part
+    void insertInto(TitleSortKey key, const Entry *entry);
+
+    void removeFrom(TitleSortKey key, const Entry *entry);
+
+    //! the orders point into the nodes, which stay where they are
+    std::unordered_map<uint64_t, Entry> entries;
+    std::vector<const Entry *> orders[SORT_KEY_COUNT];
+};
@@ -0,0 +1,76 @@
+#include "Animation.h"
+
+void Animation::start(float target, Clock::duration duration, EasingCurve curve, Clock::time_point now) {
+    //! a new target continues from where the running animation is now
+    update(now);
+    this->from   = value;
+    this->target = target;
+    this->curve  = curve;
+    startTime    = now;
+    deadline     = now + duration;
+    running      = (value != target) && (duration > Clock::duration::zero());
+    if (!running) {
+        value = target;
+    }
+}
+
+void Animation::jumpTo(float value) {
+    this->from   = value;
+    this->target = value;
+    this->value  = value;
+    running      = false;
+}
+
+float Animation::update(Clock::time_point now) {
+    if (!running) {
+        return value;
+    }
+    if (now >= deadline) {
+        value   = target;
+        running = false;
+        return value;
+    }
+
+    float t = std::chrono::duration<float>(now - startTime).count() / std::chrono::duration<float>(deadline - startTime).count();
+    if (t < 0.0f) {
+        t = 0.0f;
+    }
+    value = from + (target - from) * ease(curve, t);
+    return value;
+}
+
+float Animation::ease(EasingCurve curve, float t) {
+    switch (curve) {
+        case EASE_OUT_CUBIC: {
+            float u = 1.0f - t;
+            return 1.0f - u * u * u;
+        }
+        case EASE_IN_OUT_CUBIC: {
+            if (t < 0.5f) {
+                return 4.0f * t * t * t;
+            }
+            float u = -2.0f * t + 2.0f;
+            return 1.0f - u * u * u / 2.0f;
+        }
+        case EASE_LINEAR:
+        default:
+            return t;
+    }
+}
+
+bool RepeatTimer::poll(Animation::Clock::time_point now) {
+    if (!armed) {
+        armed    = true;
+        deadline = now + delay;
+        return false;
+    }
+    if (now < deadline) {
+        return false;
+    }
+    //! after a long stall it repeats once instead of catching up on every missed interval
+    deadline += interval;
+    if (deadline <= now) {
+        deadline = now + interval;
+    }
+    return true;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <chrono>
+#include <stdint.h>
+
+typedef enum _EasingCurve {
+    EASE_LINEAR,
+    //! fast start, slows down towards the target
+    EASE_OUT_CUBIC,
+    EASE_IN_OUT_CUBIC
+} EasingCurve;
+
+//! A value moving to a target until a deadline. The value depends on the time passed
+//! and not on the number of frames, so a dropped frame does not slow the motion down.
+class Animation {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    //! Moves from the current value to target, which is reached duration after now
+    void start(float target, Clock::duration duration, EasingCurve curve, Clock::time_point now);
+
+    //! Sets the value without animating
+    void jumpTo(float value);
+
+    //! Value at now, the target once the deadline passed
+    float update(Clock::time_point now);
+
+    bool isRunning() const {
+        return running;
+    }
+
+    float getValue() const {
+        return value;
+    }
+
+    float getTarget() const {
+        return target;
+    }
+
+    Clock::time_point getDeadline() const {
+        return deadline;
+    }
+
+    //! Progress t from 0 to 1 mapped by curve
+    static float ease(EasingCurve curve, float t);
+
+private:
+    float from        = 0.0f;
+    float target      = 0.0f;
+    float value       = 0.0f;
+    EasingCurve curve = EASE_LINEAR;
+    Clock::time_point startTime;
+    Clock::time_point deadline;
+    bool running = false;
+};
+
+//! Fires repeatedly while something is held, first after delay and then every interval
+class RepeatTimer {
+public:
+    RepeatTimer(Animation::Clock::duration delay, Animation::Clock::duration interval)
+        : delay(delay), interval(interval) {}
+
+    //! Called while held, true when a repeat is due
+    bool poll(Animation::Clock::time_point now);
+
+    void reset() {
+        armed = false;
+    }
+
+private:
+    Animation::Clock::duration delay;
+    Animation::Clock::duration interval;
+    Animation::Clock::time_point deadline;
+    bool armed = false;
+};
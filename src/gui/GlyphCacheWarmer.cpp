@@ -0,0 +1,93 @@
+#include "GlyphCacheWarmer.h"
+#include "utils/MemoryAccounting.h"
+#include <gui/FreeTypeGX.h>
+
+//! GuiText measures with its size and renders with twice the size
+static const int16_t cuGlyphSizes[] = {52, 104};
+
+std::mutex GlyphCacheWarmer::mutex;
+FreeTypeGX *GlyphCacheWarmer::font = nullptr;
+std::deque<wchar_t> GlyphCacheWarmer::pending;
+std::unordered_set<wchar_t> GlyphCacheWarmer::queued;
+std::vector<wchar_t> GlyphCacheWarmer::warmed;
+
+uint32_t GlyphCacheWarmer::getGlyphSize() {
+    uint32_t size = 0;
+    for (int16_t pixelSize : cuGlyphSizes) {
+        size += pixelSize * pixelSize;
+    }
+    return size;
+}
+
+void GlyphCacheWarmer::setFont(FreeTypeGX *f) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (font == f)
+        return;
+
+    //! the glyphs of the old font are gone with it
+    MemoryAccounting::Remove(MEMORY_GLYPH, warmed.size() * getGlyphSize());
+
+    //! the warmed characters are rasterized again first, in the order they were
+    font = f;
+    pending.insert(pending.begin(), warmed.begin(), warmed.end());
+    warmed.clear();
+}
+
+void GlyphCacheWarmer::pushLocked(wchar_t c) {
+    uint32_t budget = MemoryAccounting::GetBudget(MEMORY_GLYPH);
+    if (c < 0x20 || (budget != 0 && (queued.size() + 1) * getGlyphSize() > budget))
+        return;
+    if (!queued.insert(c).second)
+        return;
+
+    pending.push_back(c);
+}
+
+void GlyphCacheWarmer::push(const std::string &text) {
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto *p = (const uint8_t *) text.c_str();
+    while (*p) {
+        //! UTF-8 decode, invalid bytes are skipped
+        wchar_t c;
+        int32_t follow;
+        if (*p < 0x80) {
+            c      = *p;
+            follow = 0;
+        } else if ((*p & 0xE0) == 0xC0) {
+            c      = *p & 0x1F;
+            follow = 1;
+        } else if ((*p & 0xF0) == 0xE0) {
+            c      = *p & 0x0F;
+            follow = 2;
+        } else if ((*p & 0xF8) == 0xF0) {
+            c      = *p & 0x07;
+            follow = 3;
+        } else {
+            p++;
+            continue;
+        }
+        p++;
+        for (; follow > 0 && (*p & 0xC0) == 0x80; follow--, p++) {
+            c = (c << 6) | (*p & 0x3F);
+        }
+        if (follow == 0) {
+            pushLocked(c);
+        }
+    }
+}
+
+void GlyphCacheWarmer::process(uint32_t budget) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (font == nullptr)
+        return;
+
+    for (; budget > 0 && !pending.empty(); budget--) {
+        wchar_t c = pending.front();
+        pending.pop_front();
+        for (int16_t size : cuGlyphSizes) {
+            font->getCharWidth(c, size);
+        }
+        MemoryAccounting::Add(MEMORY_GLYPH, getGlyphSize());
+        warmed.push_back(c);
+    }
+}
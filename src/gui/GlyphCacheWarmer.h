@@ -0,0 +1,41 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+//! forward declaration
+class FreeTypeGX;
+
+//! Rasterizes glyphs into the FreeTypeGX cache ahead of time, a few per frame on the
+//! GUI thread, so the first title name change does not render them on demand.
+//! The cache never evicts, so only as many glyphs as fit the MEMORY_GLYPH budget are
+//! queued. Glyphs GuiText renders on demand are not counted.
+class GlyphCacheWarmer {
+public:
+    //! Font the glyphs are cached in, glyphs already warmed are queued again
+    static void setFont(FreeTypeGX *font);
+
+    //! UTF-8 text, may be called from any thread. Characters beyond the budget are dropped.
+    static void push(const std::string &text);
+
+    //! Caches at most budget glyphs, must be called from the GUI thread
+    static void process(uint32_t budget);
+
+    //! Bytes a glyph is counted with, its cells at all cached sizes with one byte per pixel
+    static uint32_t getGlyphSize();
+
+private:
+    static void pushLocked(wchar_t c);
+
+    static std::mutex mutex;
+    static FreeTypeGX *font;
+    static std::deque<wchar_t> pending;
+    //! characters pending or warmed, the budget applies to them
+    static std::unordered_set<wchar_t> queued;
+    //! characters cached in the current font, counted under MEMORY_GLYPH
+    static std::vector<wchar_t> warmed;
+};
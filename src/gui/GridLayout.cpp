@@ -0,0 +1,95 @@
+#include "GridLayout.h"
+#include <algorithm>
+#include <cmath>
+
+GridLayout::GridLayout(uint32_t cols, uint32_t rows)
+    : cols(cols), rows(rows) {
+}
+
+void GridLayout::setGeometry(float cellWidth, float cellHeight, float pageWidth, float offsetY) {
+    this->cellWidth  = cellWidth;
+    this->cellHeight = cellHeight;
+    this->pageWidth  = pageWidth;
+    this->offsetY    = offsetY;
+    invalidate();
+}
+
+void GridLayout::setVisiblePages(uint32_t first, uint32_t last) {
+    uint32_t newFirst = first * getSlotsPerPage();
+    uint32_t newEnd   = (last + 1) * getSlotsPerPage();
+    if (newFirst == firstVisible && newEnd == endVisible)
+        return;
+
+    //! slots which are hidden now have to give back their buttons
+    for (uint32_t i = firstVisible; i < endVisible; i++) {
+        if (i < newFirst || i >= newEnd)
+            markDirty(i);
+    }
+
+    uint32_t oldFirst = firstVisible;
+    uint32_t oldEnd   = endVisible;
+    firstVisible      = newFirst;
+    endVisible        = newEnd;
+
+    for (uint32_t i = firstVisible; i < endVisible; i++) {
+        if (i < oldFirst || i >= oldEnd)
+            markDirty(i);
+    }
+}
+
+void GridLayout::invalidate() {
+    for (uint32_t i = firstVisible; i < endVisible; i++) {
+        markDirty(i);
+    }
+}
+
+void GridLayout::takeDirty(std::vector<uint32_t> &out) {
+    out.clear();
+    out.swap(dirty);
+    for (uint32_t slot : out) {
+        dirtyFlags[slot] = false;
+    }
+}
+
+void GridLayout::getSlotPosition(uint32_t slot, float *x, float *y) const {
+    uint32_t page = slot / getSlotsPerPage();
+    uint32_t col  = slot % cols;
+    uint32_t row  = (slot / cols) % rows;
+
+    *x = page * pageWidth + col * cellWidth - (cols * 0.5f - 0.5f) * cellWidth;
+    *y = -(float) row * cellHeight + (rows * 0.5f - 0.5f) * cellHeight + offsetY;
+}
+
+int32_t GridLayout::getSlotAt(float x, float y) const {
+    if (pageWidth <= 0.0f || cellWidth <= 0.0f || cellHeight <= 0.0f)
+        return -1;
+
+    //! pages are centered on multiples of the page width
+    int32_t page = (int32_t) std::floor(x / pageWidth + 0.5f);
+    if (page < 0)
+        return -1;
+
+    float left  = page * pageWidth - cols * 0.5f * cellWidth;
+    float top   = rows * 0.5f * cellHeight + offsetY;
+    int32_t col = (int32_t) std::floor((x - left) / cellWidth);
+    int32_t row = (int32_t) std::floor((top - y) / cellHeight);
+    if (col < 0 || col >= (int32_t) cols || row < 0 || row >= (int32_t) rows)
+        return -1;
+
+    return page * getSlotsPerPage() + row * cols + col;
+}
+
+void GridLayout::markDirty(uint32_t slot) {
+    //! hidden slots are laid out once they become visible
+    if (!isVisible(slot))
+        return;
+
+    if (slot >= dirtyFlags.size()) {
+        dirtyFlags.resize(std::max<uint32_t>(slot + 1, dirtyFlags.size() * 2), false);
+    }
+    if (dirtyFlags[slot])
+        return;
+
+    dirtyFlags[slot] = true;
+    dirty.push_back(slot);
+}
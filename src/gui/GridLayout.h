@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+//! Geometry of a paged icon grid and the slots one view shows. Only changes to visible
+//! slots are recorded, so the view lays out what changed instead of the whole grid.
+//! The title ids in the slots are kept by IconGridModel.
+class GridLayout {
+public:
+    GridLayout(uint32_t cols, uint32_t rows);
+
+    //! Distance between two icons, width of a page and vertical offset of the grid
+    void setGeometry(float cellWidth, float cellHeight, float pageWidth, float offsetY);
+
+    uint32_t getSlotsPerPage() const {
+        return cols * rows;
+    }
+
+    //! Pages first to last are shown, the slots entering or leaving them become dirty
+    void setVisiblePages(uint32_t first, uint32_t last);
+
+    bool isVisible(uint32_t slot) const {
+        return slot >= firstVisible && slot < endVisible;
+    }
+
+    uint32_t getFirstVisible() const {
+        return firstVisible;
+    }
+
+    uint32_t getEndVisible() const {
+        return endVisible;
+    }
+
+    //! Records that the content of a slot changed, hidden slots are ignored
+    void markDirty(uint32_t slot);
+
+    //! Marks all visible slots dirty
+    void invalidate();
+
+    //! Moves the slots which changed since the last call into out
+    void takeDirty(std::vector<uint32_t> &out);
+
+    //! Position of a slot relative to the first page
+    void getSlotPosition(uint32_t slot, float *x, float *y) const;
+
+    //! Slot whose cell contains x, y relative to the first page, -1 if there is none
+    int32_t getSlotAt(float x, float y) const;
+
+private:
+    uint32_t cols;
+    uint32_t rows;
+    float cellWidth  = 0.0f;
+    float cellHeight = 0.0f;
+    float pageWidth  = 0.0f;
+    float offsetY    = 0.0f;
+
+    uint32_t firstVisible = 0;
+    uint32_t endVisible   = 0;
+
+    std::vector<uint32_t> dirty;
+    std::vector<bool> dirtyFlags;
+};
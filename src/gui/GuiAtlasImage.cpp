@@ -0,0 +1,51 @@
+#include "GuiAtlasImage.h"
+#include "resources/UiAtlas.h"
+#include "utils/logger.h"
+#include <gui/video/shaders/Texture2DShader.h>
+#include <malloc.h>
+
+GuiAtlasImage::GuiAtlasImage(const char *spriteName)
+    : GuiImage((GuiImageData *) nullptr) {
+    const UiAtlasSprite *sprite = UiAtlas::FindSprite(spriteName);
+    if (!sprite) {
+        DEBUG_FUNCTION_LINE("Sprite %s is not in the UI atlas", spriteName);
+        return;
+    }
+
+    texCoords = (float *) memalign(GX2_VERTEX_BUFFER_ALIGNMENT, Shader::cuTexCoordAttrSize * 4);
+    if (!texCoords)
+        return;
+
+    GuiImageData *atlas = UiAtlas::Acquire();
+    hasAtlas            = true;
+    setImageData(atlas);
+    setSize(sprite->width, sprite->height);
+
+    const float u0 = (float) sprite->x / (float) UiAtlas::GetWidth();
+    const float v0 = (float) sprite->y / (float) UiAtlas::GetHeight();
+    const float u1 = (float) (sprite->x + sprite->width) / (float) UiAtlas::GetWidth();
+    const float v1 = (float) (sprite->y + sprite->height) / (float) UiAtlas::GetHeight();
+
+    //! same vertex order as the default quad of the Texture2DShader
+    int32_t i      = 0;
+    texCoords[i++] = u0;
+    texCoords[i++] = v1;
+    texCoords[i++] = u1;
+    texCoords[i++] = v1;
+    texCoords[i++] = u1;
+    texCoords[i++] = v0;
+    texCoords[i++] = u0;
+    texCoords[i++] = v0;
+    GX2Invalidate(GX2_INVALIDATE_MODE_CPU_ATTRIBUTE_BUFFER, texCoords, Shader::cuTexCoordAttrSize * 4);
+}
+
+GuiAtlasImage::~GuiAtlasImage() {
+    if (texCoords) {
+        free(texCoords);
+        texCoords = nullptr;
+    }
+    if (hasAtlas) {
+        imageData = nullptr;
+        UiAtlas::Release();
+    }
+}
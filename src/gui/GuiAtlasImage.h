@@ -0,0 +1,15 @@
+#pragma once
+
+#include <gui/GuiImage.h>
+
+//! Image of a sprite in the UI atlas. It draws the shared atlas texture with the
+//! texture coordinates of the sprite, so all atlas sprites use one texture.
+class GuiAtlasImage : public GuiImage {
+public:
+    explicit GuiAtlasImage(const char *spriteName);
+
+    virtual ~GuiAtlasImage();
+
+private:
+    bool hasAtlas = false;
+};
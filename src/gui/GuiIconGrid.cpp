@@ -17,18 +17,20 @@
 #include "Application.h"
 #include "common/common.h"
 #include "gui/GameIcon.h"
+#include "resources/SfxPool.h"
 #include "utils/logger.h"
 #include <algorithm>
+#include <cmath>
 #include <coreinit/cache.h>
 #include <gui/GuiController.h>
 #include <gui/GuiIconGrid.h>
 #include <gui/video/CVideo.h>
 #include <map>
 
-GuiIconGrid::GuiIconGrid(int32_t w, int32_t h, uint64_t GameIndex, bool sortByName)
-    : GuiTitleBrowser(w, h, GameIndex),
-      sortByName(sortByName),
-      particleBgImage(w, h, 50, 60.0f, 90.0f, 0.6f, 1.0f), buttonClickSound(Resources::GetSound("button_click.mp3")), gameTitle((char *) nullptr, 52, glm::vec4(1.0f)),
+GuiIconGrid::GuiIconGrid(int32_t w, int32_t h, IconGridModel &model)
+    : GuiTitleBrowser(w, h, model.getSelected()),
+      model(model),
+      particleBgImage(w, h, 50, 60.0f, 90.0f, 0.6f, 1.0f), gameTitle((char *) nullptr, 52, glm::vec4(1.0f)),
       touchTrigger(GuiTrigger::CHANNEL_1, GuiTrigger::VPAD_TOUCH),
       wpadTouchTrigger(GuiTrigger::CHANNEL_2 | GuiTrigger::CHANNEL_3 | GuiTrigger::CHANNEL_4 | GuiTrigger::CHANNEL_5, GuiTrigger::BUTTON_A),
       leftTrigger(GuiTrigger::CHANNEL_ALL, GuiTrigger::BUTTON_LEFT | GuiTrigger::STICK_L_LEFT, true),
@@ -36,16 +38,17 @@ GuiIconGrid::GuiIconGrid(int32_t w, int32_t h, uint64_t GameIndex, bool sortByNa
       downTrigger(GuiTrigger::CHANNEL_ALL, GuiTrigger::BUTTON_DOWN | GuiTrigger::STICK_L_DOWN, true), upTrigger(GuiTrigger::CHANNEL_ALL, GuiTrigger::BUTTON_UP | GuiTrigger::STICK_L_UP, true),
       buttonATrigger(GuiTrigger::CHANNEL_ALL, GuiTrigger::BUTTON_A, true), buttonLTrigger(GuiTrigger::CHANNEL_ALL, GuiTrigger::BUTTON_L, true),
       buttonRTrigger(GuiTrigger::CHANNEL_ALL, GuiTrigger::BUTTON_R, true), leftButton(w, h), rightButton(w, h), downButton(w, h), upButton(w, h), launchButton(w, h),
-      arrowRightImageData(Resources::GetImageData("rightArrow.png")), arrowLeftImageData(Resources::GetImageData("leftArrow.png")), arrowRightImage(arrowRightImageData),
-      arrowLeftImage(arrowLeftImageData), arrowRightButton(arrowRightImage.getWidth(), arrowRightImage.getHeight()), arrowLeftButton(arrowLeftImage.getWidth(), arrowLeftImage.getHeight()),
-      noIcon(Resources::GetFile("noGameIcon.png"), Resources::GetFileSize("noGameIcon.png"), GX2_TEX_CLAMP_MODE_MIRROR),
-      emptyIcon(Resources::GetFile("iconEmpty.png"), Resources::GetFileSize("iconEmpty.png"), GX2_TEX_CLAMP_MODE_MIRROR), dragListener(w, h) {
+      arrowRightImage("rightArrow.png"), arrowLeftImage("leftArrow.png"), arrowRightButton(arrowRightImage.getWidth(), arrowRightImage.getHeight()), arrowLeftButton(arrowLeftImage.getWidth(), arrowLeftImage.getHeight()),
+      noIcon(Resources::GetImageData(RESOURCE_ID("noGameIcon.png"))), emptyIcon(Resources::GetImageData(RESOURCE_ID("iconEmpty.png"))), dragListener(w, h),
+      lArrowRepeat(ARROW_REPEAT_TIME, ARROW_REPEAT_TIME), rArrowRepeat(ARROW_REPEAT_TIME, ARROW_REPEAT_TIME), layout(MAX_COLS, MAX_ROWS), pageFrame(w, h) {
 
     particleBgImage.setParent(this);
-    setSelectedGame(GameIndex);
-    listOffset          = selectedGame / (MAX_COLS * MAX_ROWS);
+    //! the page of a session snapshot, the arrows and the scroll follow curPage
+    listOffset          = model.getStartPage();
+    curPage             = listOffset;
     targetLeftPosition  = -listOffset * getWidth();
     currentLeftPosition = targetLeftPosition;
+    scrollAnimation.jumpTo(currentLeftPosition);
 
     leftButton.setTrigger(&leftTrigger);
     leftButton.clicked.connect(this, &GuiIconGrid::OnLeftClick);
@@ -64,7 +67,6 @@ GuiIconGrid::GuiIconGrid(int32_t w, int32_t h, uint64_t GameIndex, bool sortByNa
     this->append(&upButton);
 
     launchButton.setTrigger(&buttonATrigger);
-    launchButton.setSoundClick(buttonClickSound);
     launchButton.clicked.connect(this, &GuiIconGrid::OnLaunchClick);
     this->append(&launchButton);
 
@@ -76,7 +78,6 @@ GuiIconGrid::GuiIconGrid(int32_t w, int32_t h, uint64_t GameIndex, bool sortByNa
     arrowLeftButton.setTrigger(&wpadTouchTrigger);
     arrowLeftButton.setTrigger(&buttonLTrigger);
     arrowLeftButton.setHoldable(true);
-    arrowLeftButton.setSoundClick(buttonClickSound);
     arrowLeftButton.clicked.connect(this, &GuiIconGrid::OnLeftArrowClick);
     arrowLeftButton.held.connect(this, &GuiIconGrid::OnLeftArrowHeld);
     arrowLeftButton.released.connect(this, &GuiIconGrid::OnLeftArrowReleased);
@@ -91,26 +92,40 @@ GuiIconGrid::GuiIconGrid(int32_t w, int32_t h, uint64_t GameIndex, bool sortByNa
     arrowRightButton.setTrigger(&wpadTouchTrigger);
     arrowRightButton.setTrigger(&buttonRTrigger);
     arrowRightButton.setHoldable(true);
-    arrowRightButton.setSoundClick(buttonClickSound);
     arrowRightButton.clicked.connect(this, &GuiIconGrid::OnRightArrowClick);
     arrowRightButton.held.connect(this, &GuiIconGrid::OnRightArrowHeld);
     arrowRightButton.released.connect(this, &GuiIconGrid::OnRightArrowReleased);
     append(&arrowRightButton);
 
-    // at most we are rendering 2 screens at the same time
-    for (int i = 0; i < MAX_COLS * MAX_ROWS * 2; i++) {
-        GameIcon *image = new GameIcon(&emptyIcon);
-        emptyIcons.push_back(image);
-        GuiButton *button = new GuiButton(emptyIcon.getWidth(), emptyIcon.getHeight());
+    //! the widgets are bound to the slots around the view instead of created per title,
+    //! one more replaces the icon which is dragged around
+    widgets.resize(MAX_COLS * MAX_ROWS * POOL_PAGES + 1);
+    for (auto &widget : widgets) {
+        GameIcon *image = new GameIcon(emptyIcon);
+        image->setRenderReflection(false);
+
+        GuiButton *button = new GuiButton(noIcon->getWidth(), noIcon->getHeight());
         button->setImage(image);
         button->setPosition(0, 0);
-        //button->setEffectGrow();
-        button->setHoldable(true);
         button->setTrigger(&touchTrigger);
+        button->setTrigger(&wpadTouchTrigger);
+        button->clicked.connect(this, &GuiIconGrid::OnGameButtonClick);
+        button->setHoldable(true);
         button->held.connect(this, &GuiIconGrid::OnGameButtonHeld);
-        emptyButtons.push_back(button);
+        button->pointedOn.connect(this, &GuiIconGrid::OnGameButtonPointedOn);
+        button->pointedOff.connect(this, &GuiIconGrid::OnGameButtonPointedOff);
+
+        widget.image            = image;
+        widget.button           = button;
+        widgetOfButtons[button] = &widget;
+    }
+    for (auto itr = widgets.rbegin(); itr != widgets.rend(); ++itr) {
+        freeWidgets.push_back(&*itr);
     }
 
+    layout.setGeometry(noIcon->getWidth() * 1.5f, noIcon->getHeight() * 1.5f, getWidth(), 30.0f);
+    pageFrame.setPosition(currentLeftPosition, 0);
+
     dragListener.setTrigger(&touchTrigger);
     dragListener.setTrigger(&wpadTouchTrigger);
     dragListener.dragged.connect(this, &GuiIconGrid::OnDrag);
@@ -122,59 +137,73 @@ GuiIconGrid::GuiIconGrid(int32_t w, int32_t h, uint64_t GameIndex, bool sortByNa
     gameTitle.setMaxWidth(900, GuiText::DOTTED);
     gameTitle.setText("");
     append(&gameTitle);
-}
-
-GuiIconGrid::~GuiIconGrid() {
-    containerMutex.lock();
-    for (auto const &x : gameInfoContainers) {
-        remove(x.second->button);
-        delete x.second;
-    }
-    gameInfoContainers.clear();
-    containerMutex.unlock();
 
-    for (auto const &x : emptyButtons) {
-        delete x;
-    }
+    append(&pageFrame);
 
-    for (auto const &x : emptyIcons) {
-        delete x;
-    }
+    model.addLayout(&layout);
+    model.slotChanged.connect(this, &GuiIconGrid::OnModelSlotChanged);
+    model.selectionChanged.connect(this, &GuiIconGrid::OnModelSelectionChanged);
+    model.titleUpdated.connect(this, &GuiIconGrid::OnModelTitleUpdated);
+    model.titleListChanged.connect(this, &GuiIconGrid::OnModelTitleListChanged);
+}
 
-    emptyButtons.clear();
-    emptyIcons.clear();
+GuiIconGrid::~GuiIconGrid() {
+    model.lock();
+    model.slotChanged.disconnect(this);
+    model.selectionChanged.disconnect(this);
+    model.titleUpdated.disconnect(this);
+    model.titleListChanged.disconnect(this);
+    model.removeLayout(&layout);
+    if (heldWidget != nullptr) {
+        model.drop(-1);
+    }
+    pageFrame.removeAll();
+    model.unlock();
+
+    for (auto const &widget : widgets) {
+        delete widget.button;
+        delete widget.image;
+    }
+    widgets.clear();
+
+    Resources::RemoveImageData(noIcon);
+    Resources::RemoveImageData(emptyIcon);
 }
 
 int32_t GuiIconGrid::offsetForTitleId(uint64_t titleId) {
-    int32_t offset = -1;
-    positionMutex.lock();
-    for (uint32_t i = 0; i < position.size(); i++) {
-        if (position.at(i) == titleId) {
-            offset = i;
-            break;
-        }
-    }
-    positionMutex.unlock();
+    model.lock();
+    int32_t offset = model.find(titleId);
+    model.unlock();
     return offset;
 }
 
 void GuiIconGrid::setSelectedGame(uint64_t idx) {
-    this->selectedGame = idx;
-
-    containerMutex.lock();
-    GameInfoContainer *container = nullptr;
-    for (auto const &x : gameInfoContainers) {
-        container = x.second;
-        if (x.first == idx) {
-            container->image->setSelected(true);
-            gameTitle.setText(container->info->name.c_str());
-        } else {
-            container->image->setSelected(false);
-        }
+    //! both views follow the selection of the model
+    model.setSelected(idx);
+}
+
+uint64_t GuiIconGrid::getSelectedGame(void) {
+    return model.getSelected();
+}
+
+uint32_t GuiIconGrid::getCurrentPage(void) {
+    model.lock();
+    uint32_t page = curPage;
+    model.unlock();
+    return page;
+}
+
+void GuiIconGrid::OnModelSelectionChanged(uint64_t titleId) {
+    gameInfo *info = model.getInfo(titleId);
+    if (info != nullptr) {
+        gameTitle.setText(info->name.c_str());
+    }
+    //! only the bound widgets show a selection
+    for (auto &widget : widgets) {
+        widget.image->setSelected((widget.titleId != 0 && widget.titleId == titleId) || (widget.slot >= 0 && widget.slot == dragTargetSlot));
     }
-    containerMutex.unlock();
 
-    int32_t offset = offsetForTitleId(getSelectedGame());
+    int32_t offset = model.find(titleId);
     if (offset > 0) {
         uint32_t newPage = offset / (MAX_COLS * MAX_ROWS);
         if (newPage != (uint32_t) curPage) {
@@ -184,70 +213,42 @@ void GuiIconGrid::setSelectedGame(uint64_t idx) {
     }
 }
 
-uint64_t GuiIconGrid::getSelectedGame(void) {
-    return selectedGame;
-}
-
-void GuiIconGrid::OnGameTitleListUpdated(GameList *gameList) {
-    gameList->lock();
-    containerMutex.lock();
-    positionMutex.lock();
-    // At first delete the ones that were deleted;
-    auto it = gameInfoContainers.begin();
-    while (it != gameInfoContainers.end()) {
-        bool wasFound = false;
-        for (int32_t i = 0; i < gameList->size(); i++) {
-            gameInfo *info = gameList->at(i);
-            if (info != nullptr && info->titleId == it->first) {
-                wasFound = true;
-                break;
-            }
-        }
-
-        if (!wasFound) {
-            DEBUG_FUNCTION_LINE("Removing %016llX", it->first);
-            remove(it->second->button);
-            delete it->second;
-            it = gameInfoContainers.erase(it);
-        } else {
-            ++it;
-        }
+void GuiIconGrid::OnModelSlotChanged(uint32_t slot) {
+    layout.markDirty(slot);
+    //! a swap while dragging only rebinds the widgets of its two slots
+    if (model.getPageCount(layout.getSlotsPerPage()) != pageCount) {
+        bUpdatePositions = true;
     }
+}
 
-    for (int32_t i = 0; i < gameList->size(); i++) {
-        gameInfo *info               = gameList->at(i);
-        GameInfoContainer *container = nullptr;
-
-        for (auto const &x : gameInfoContainers) {
-            if (info->titleId == x.first) {
-                container = x.second;
-                break;
-            }
-        }
-        if (container == nullptr) {
-            OnGameTitleAdded(info);
-        }
+void GuiIconGrid::OnModelTitleListChanged() {
+    gameSelectionChanged(this, model.getSelected());
+    //! a changed filter starts at the first page, the enumerated list keeps the page of a session snapshot
+    if (model.isFiltered() || shownFiltered) {
+        curPage             = 0;
+        currentLeftPosition = 0;
+        scrollAnimation.jumpTo(currentLeftPosition);
     }
-    positionMutex.unlock();
-    containerMutex.unlock();
-    gameList->unlock();
-    setSelectedGame(0);
-    gameSelectionChanged(this, selectedGame);
-    curPage             = 0;
-    currentLeftPosition = 0;
-    bUpdatePositions    = true;
+    shownFiltered    = model.isFiltered();
+    bUpdatePositions = true;
 }
 
 void GuiIconGrid::OnLeftArrowClick(GuiButton *button, const GuiController *controller, GuiTrigger *trigger) {
+    SfxPool::Play(RESOURCE_ID("button_click.mp3"));
     //setSelectedGame(0);
+    model.lock();
     curPage--;
     bUpdatePositions = true;
+    model.unlock();
 }
 
 void GuiIconGrid::OnRightArrowClick(GuiButton *button, const GuiController *controller, GuiTrigger *trigger) {
+    SfxPool::Play(RESOURCE_ID("button_click.mp3"));
     //setSelectedGame(0);
+    model.lock();
     curPage++;
     bUpdatePositions = true;
+    model.unlock();
 }
 
 void GuiIconGrid::OnLeftClick(GuiButton *button, const GuiController *controller, GuiTrigger *trigger) {
@@ -260,13 +261,13 @@ void GuiIconGrid::OnLeftClick(GuiButton *button, const GuiController *controller
     } else {
         offset--;
     }
-    if (offset < 0 || position.empty()) {
+    if (offset < 0 || model.getSlotCount() == 0) {
         return;
     }
-    uint64_t newTitleId = position.at(offset);
+    uint64_t newTitleId = model.getSlot(offset);
     if (newTitleId > 0) {
         setSelectedGame(newTitleId);
-        gameSelectionChanged(this, selectedGame);
+        gameSelectionChanged(this, getSelectedGame());
     }
 }
 
@@ -280,13 +281,13 @@ void GuiIconGrid::OnRightClick(GuiButton *button, const GuiController *controlle
     } else {
         offset++;
     }
-    if ((uint32_t) offset >= position.size()) {
+    if ((uint32_t) offset >= model.getSlotCount()) {
         return;
     }
-    uint64_t newTitleId = position.at(offset);
+    uint64_t newTitleId = model.getSlot(offset);
     if (newTitleId > 0) {
         setSelectedGame(newTitleId);
-        gameSelectionChanged(this, selectedGame);
+        gameSelectionChanged(this, getSelectedGame());
     }
 }
 
@@ -301,13 +302,13 @@ void GuiIconGrid::OnDownClick(GuiButton *button, const GuiController *controller
         return;
     }
 
-    if ((uint32_t) offset >= position.size()) {
+    if ((uint32_t) offset >= model.getSlotCount()) {
         return;
     }
-    uint64_t newTitleId = position.at(offset);
+    uint64_t newTitleId = model.getSlot(offset);
     if (newTitleId > 0) {
         setSelectedGame(newTitleId);
-        gameSelectionChanged(this, selectedGame);
+        gameSelectionChanged(this, getSelectedGame());
     }
 }
 
@@ -325,72 +326,80 @@ void GuiIconGrid::OnUpClick(GuiButton *button, const GuiController *controller,
     if (offset < 0) {
         return;
     }
-    uint64_t newTitleId = position.at(offset);
+    uint64_t newTitleId = model.getSlot(offset);
     if (newTitleId > 0) {
         setSelectedGame(newTitleId);
-        gameSelectionChanged(this, selectedGame);
+        gameSelectionChanged(this, getSelectedGame());
     }
 }
 
 void GuiIconGrid::OnLaunchClick(GuiButton *button, const GuiController *controller, GuiTrigger *trigger) {
+    //! game buttons play their click themselves before forwarding here
+    if (button == &launchButton) {
+        SfxPool::Play(RESOURCE_ID("button_click.mp3"));
+    }
+
     //! do not auto launch when wiimote is pointing to screen and presses A
     if ((trigger == &buttonATrigger) && (controller->chan & (GuiTrigger::CHANNEL_2 | GuiTrigger::CHANNEL_3 | GuiTrigger::CHANNEL_4 | GuiTrigger::CHANNEL_5)) && controller->data.validPointer) {
         return;
     }
-    DEBUG_FUNCTION_LINE("Tried to launch %s (%016llX)", gameInfoContainers[getSelectedGame()]->info->name.c_str(), getSelectedGame());
+    gameInfo *info = model.getInfo(getSelectedGame());
+    DEBUG_FUNCTION_LINE("Tried to launch %s (%016llX)", info ? info->name.c_str() : "", getSelectedGame());
     gameLaunchClicked(this, getSelectedGame());
 }
 
 
 void GuiIconGrid::OnLeftArrowHeld(GuiButton *button, const GuiController *controller, GuiTrigger *trigger) {
     if (currentlyHeld != nullptr) {
-        if (lArrowHeldCounter++ > 30) {
+        setHeldTurnDirection(-1);
+        if (lArrowRepeat.poll(Animation::Clock::now())) {
             OnLeftArrowClick(button, controller, trigger);
-            lArrowHeldCounter = 0;
         }
     } else {
-        lArrowHeldCounter = 0;
+        setHeldTurnDirection(0);
+        lArrowRepeat.reset();
     }
 }
 
 void GuiIconGrid::OnLeftArrowReleased(GuiButton *button, const GuiController *controller, GuiTrigger *trigger) {
-    lArrowHeldCounter = 0;
+    setHeldTurnDirection(0);
+    lArrowRepeat.reset();
 }
 
 void GuiIconGrid::OnRightArrowHeld(GuiButton *button, const GuiController *controller, GuiTrigger *trigger) {
     if (currentlyHeld != nullptr) {
-        if (rArrowHeldCounter++ > 30) {
+        setHeldTurnDirection(1);
+        if (rArrowRepeat.poll(Animation::Clock::now())) {
             DEBUG_FUNCTION_LINE("CLICK");
             OnRightArrowClick(button, controller, trigger);
-            rArrowHeldCounter = 0;
         }
     } else {
-        rArrowHeldCounter = 0;
+        setHeldTurnDirection(0);
+        rArrowRepeat.reset();
     }
 }
 
 void GuiIconGrid::OnRightArrowReleased(GuiButton *button, const GuiController *controller, GuiTrigger *trigger) {
-    rArrowHeldCounter = 0;
+    setHeldTurnDirection(0);
+    rArrowRepeat.reset();
+}
+
+void GuiIconGrid::setHeldTurnDirection(int32_t direction) {
+    if (direction != heldTurnDirection) {
+        heldTurnDirection = direction;
+        pageTurnHeld(this, direction);
+    }
 }
 
 
 void GuiIconGrid::OnGameButtonHeld(GuiButton *button, const GuiController *controller, GuiTrigger *trigger) {
     if (currentlyHeld == nullptr) {
-        bool found = false;
         // We don't want to drag empty buttons
-        for (auto const &x : emptyButtons) {
-            if (x == button) {
-                found = true;
-                break;
-            }
-        }
-        if (!found) {
+        SlotWidget *widget = widgetOfButton(button);
+        if (widget != nullptr && widget->titleId != 0) {
             currentlyHeld = button;
         }
     }
-    if (currentlyHeld != nullptr && currentlyHeld != button) {
-        dragTarget = button;
-    }
 }
 
 void GuiIconGrid::OnGameButtonPointedOn(GuiButton *button, const GuiController *controller) {
@@ -402,241 +411,228 @@ void GuiIconGrid::OnGameButtonPointedOff(GuiButton *button, const GuiController
 void GuiIconGrid::OnDrag(GuiDragListener *element, const GuiController *controller, GuiTrigger *trigger, int32_t dx, int32_t dy) {
     if (currentlyHeld != nullptr) {
         currentlyHeld->setPosition(currentlyHeld->getOffsetX() + dx, currentlyHeld->getOffsetY() + dy);
+
+        //! the icon is a child of the page frame, so its offset is in the coordinates of the cells
+        model.lock();
+        int32_t slot = layout.getSlotAt(currentlyHeld->getOffsetX(), currentlyHeld->getOffsetY());
+        if (heldWidget == nullptr || slot < (int32_t) shownFirst || slot >= (int32_t) shownEnd || (uint32_t) slot >= model.getSlotCount()) {
+            slot = -1;
+        }
+        setDragTarget(slot);
+        model.unlock();
     }
-    // reset the target when we move.
-    dragTarget = nullptr;
 }
 
 void GuiIconGrid::OnGameButtonClick(GuiButton *button, const GuiController *controller, GuiTrigger *trigger) {
-    containerMutex.lock();
-    for (auto const &x : gameInfoContainers) {
-        if (x.second->button == button) {
-            if (selectedGame == (x.second->info->titleId)) {
-                if (gameLaunchTimer < 30)
-                    OnLaunchClick(button, controller, trigger);
-            } else {
-                setSelectedGame(x.second->info->titleId);
-                gameSelectionChanged(this, selectedGame);
-            }
-            gameLaunchTimer = 0;
-            break;
+    model.lock();
+    SlotWidget *widget = widgetOfButton(button);
+    if (widget != nullptr && widget->titleId != 0) {
+        SfxPool::Play(RESOURCE_ID("button_click.mp3"));
+        Animation::Clock::time_point now = Animation::Clock::now();
+        if (getSelectedGame() == widget->titleId) {
+            if (now - lastGameClick < LAUNCH_TAP_TIME)
+                OnLaunchClick(button, controller, trigger);
+        } else {
+            setSelectedGame(widget->titleId);
+            gameSelectionChanged(this, getSelectedGame());
         }
+        lastGameClick = now;
     }
-    containerMutex.unlock();
-}
-
-void GuiIconGrid::OnGameTitleAdded(gameInfo *info) {
-    DEBUG_FUNCTION_LINE("Adding %016llX", info->titleId);
-    GuiImageData *imageData = &noIcon;
-    if (info->imageData != nullptr) {
-        imageData = info->imageData;
-    }
-    GameIcon *image = new GameIcon(imageData);
-    image->setRenderReflection(false);
-    image->setStrokeRender(false);
-    image->setSelected(info->titleId == selectedGame);
-    image->setRenderIconLast(true);
-
-    GuiButton *button = new GuiButton(noIcon.getWidth(), noIcon.getHeight());
-    button->setImage(image);
-    button->setPosition(0, 0);
-    button->setEffectGrow();
-    button->setTrigger(&touchTrigger);
-    button->setTrigger(&wpadTouchTrigger);
-    button->setSoundClick(buttonClickSound);
-    //button->setClickable( (idx < gameList->size()) );
-    //button->setSelectable( (idx < gameList->size()) );
-    button->clicked.connect(this, &GuiIconGrid::OnGameButtonClick);
-    button->setHoldable(true);
-    button->held.connect(this, &GuiIconGrid::OnGameButtonHeld);
-    button->pointedOn.connect(this, &GuiIconGrid::OnGameButtonPointedOn);
-    button->pointedOff.connect(this, &GuiIconGrid::OnGameButtonPointedOff);
-    //button->dragged.connect(this, &GuiIconGrid::OnGameButtonDragged);
-
-    GameInfoContainer *container = new GameInfoContainer(button, image, info);
-    containerMutex.lock();
-    gameInfoContainers[info->titleId] = container;
-    containerMutex.unlock();
-    this->append(button);
-
-    positionMutex.lock();
-    bool foundFreePlace = false;
-    for (uint32_t i = 0; i < position.size(); i++) {
-        if (position[i] == 0) {
-            position[i]    = info->titleId;
-            foundFreePlace = true;
-            break;
+    model.unlock();
+}
+
+void GuiIconGrid::OnModelTitleUpdated(gameInfo *info) {
+    //! icons freed by the budget of the GameList show the placeholder again
+    for (auto &widget : widgets) {
+        if (widget.titleId == info->titleId) {
+            widget.image->setImageData(info->imageData ? info->imageData : noIcon);
         }
     }
-    if (!foundFreePlace) {
-        position.push_back(info->titleId);
-    }
-    positionMutex.unlock();
+}
 
-    bUpdatePositions = true;
+GuiIconGrid::SlotWidget *GuiIconGrid::widgetOfButton(GuiButton *button) {
+    auto itr = widgetOfButtons.find(button);
+    return (itr != widgetOfButtons.end()) ? itr->second : nullptr;
 }
 
-void GuiIconGrid::OnGameTitleUpdated(gameInfo *info) {
-    DEBUG_FUNCTION_LINE("Updating infos of %016llX", info->titleId);
-    GameInfoContainer *container = nullptr;
-    containerMutex.lock();
-    for (auto const &x : gameInfoContainers) {
-        if (info->titleId == x.first) {
-            container = x.second;
-            break;
-        }
-    }
+void GuiIconGrid::bindWidget(SlotWidget *widget, uint32_t slot) {
+    gameInfo *info = model.getInfo(model.getSlot(slot));
+
+    widget->slot    = slot;
+    widget->titleId = info ? info->titleId : 0;
 
-    // keep the lock to delay the draw() until the image data is ready.
-    if (container != nullptr) {
-        container->updateImageData();
+    GameIcon *image = widget->image;
+    if (info == nullptr) {
+        image->setImageData(emptyIcon);
+        image->setStrokeRender(true);
+        image->setRenderIconLast(false);
+        image->setSelected((int32_t) slot == dragTargetSlot);
+        widget->button->resetEffects();
+        widget->button->setHoldable(true);
+    } else {
+        image->setImageData(info->imageData ? info->imageData : noIcon);
+        image->setStrokeRender(false);
+        image->setRenderIconLast(true);
+        image->setSelected(info->titleId == model.getSelected() || (int32_t) slot == dragTargetSlot);
+        widget->button->setEffectGrow();
+        widget->button->setHoldable(!scrolling);
     }
 
-    containerMutex.unlock();
+    float posX, posY;
+    layout.getSlotPosition(slot, &posX, &posY);
+    widget->button->setPosition(posX, posY);
 
-    bUpdatePositions = true;
+    if (slot >= slotWidgets.size()) {
+        slotWidgets.resize(slot + 1, nullptr);
+    }
+    slotWidgets[slot] = widget;
+    setWidgetAttached(widget, slot >= shownFirst && slot < shownEnd);
 }
 
-void GuiIconGrid::process() {
-    if (currentlyHeld != nullptr) {
-        if (!currentlyHeld->isStateSet(GuiElement::STATE_HELD)) {
-            DEBUG_FUNCTION_LINE("Not held anymore");
-            positionMutex.lock();
-            if (dragTarget) {
-                DEBUG_FUNCTION_LINE("Let's swap");
-
-                std::vector<std::pair<uint64_t, GameInfoContainer *>> vec;
-                containerMutex.lock();
-                // copy key-value pairs from the map to the vector
-                std::copy(gameInfoContainers.begin(), gameInfoContainers.end(), std::back_inserter<std::vector<std::pair<uint64_t, GameInfoContainer *>>>(vec));
-                containerMutex.unlock();
-                uint64_t targetTitleId = 0;
-                for (auto const &x : vec) {
-                    if (x.second->button == dragTarget) {
-                        targetTitleId = x.first;
-                        break;
-                    }
-                }
-                for (uint32_t i = 0; i < positionButtons.size(); i++) {
-                    if (positionButtons[i] == dragTarget) {
-                        if (i < position.size() && (int32_t) i != currentlyHeldPosition) {
-                            position[i] = currentlyHeldTitleId;
-                            DEBUG_FUNCTION_LINE("Set position to title id to %d", i, currentlyHeldPosition);
-                        } else {
-                            targetTitleId = currentlyHeldTitleId;
-                        }
-
-                        break;
-                    }
-                }
-                if (currentlyHeldPosition >= 0 && currentlyHeldPosition <= (int32_t) position.size()) {
-                    position[currentlyHeldPosition] = targetTitleId;
-                }
-
-                dragTarget = nullptr;
-            } else {
-                if (currentlyHeldPosition >= 0 && currentlyHeldPosition <= (int32_t) position.size()) {
-                    position[currentlyHeldPosition] = currentlyHeldTitleId;
-                }
-            }
-            positionMutex.unlock();
-            currentlyHeld        = nullptr;
-            currentlyHeldTitleId = 0;
+void GuiIconGrid::releaseWidget(SlotWidget *widget) {
+    setWidgetAttached(widget, false);
+    if (widget->slot >= 0 && (uint32_t) widget->slot < slotWidgets.size() && slotWidgets[widget->slot] == widget) {
+        slotWidgets[widget->slot] = nullptr;
+    }
+    widget->slot    = -1;
+    widget->titleId = 0;
+    freeWidgets.push_back(widget);
+}
 
-            currentlyHeldPosition = -1;
-            bUpdatePositions      = true;
-        } else {
-            //DEBUG_FUNCTION_LINE("Holding it");
-            bUpdatePositions = true;
-        }
+void GuiIconGrid::setWidgetAttached(SlotWidget *widget, bool attach) {
+    if (widget->attached == attach) {
+        return;
     }
+    if (attach) {
+        pageFrame.append(widget->button);
+    } else {
+        pageFrame.remove(widget->button);
+    }
+    widget->attached = attach;
+}
 
-    if (currentLeftPosition < targetLeftPosition) {
-        currentLeftPosition += 35;
+void GuiIconGrid::pickUpHeldButton() {
+    model.lock();
+    SlotWidget *widget = widgetOfButton(currentlyHeld);
+    if (widget == nullptr || widget->slot < 0 || widget->titleId == 0 || !model.pickUp(widget->slot)) {
+        //! the other view may be dragging a title already
+        currentlyHeld = nullptr;
+    } else {
+        //! the widget leaves its slot, which gets another one showing the empty icon
+        heldWidget                = widget;
+        slotWidgets[widget->slot] = nullptr;
+        widget->slot              = -1;
+    }
+    model.unlock();
+}
 
-        if (currentLeftPosition > targetLeftPosition)
-            currentLeftPosition = targetLeftPosition;
+void GuiIconGrid::dropHeldButton() {
+    DEBUG_FUNCTION_LINE("Not held anymore");
+    model.lock();
+    if (heldWidget != nullptr) {
+        //! the pages may have been turned since the icon was last moved
+        int32_t target = (dragTargetSlot >= (int32_t) shownFirst && dragTargetSlot < (int32_t) shownEnd) ? dragTargetSlot : -1;
+        setDragTarget(-1);
+        model.drop(target);
+        releaseWidget(heldWidget);
+        heldWidget = nullptr;
+    }
+    model.unlock();
+
+    currentlyHeld = nullptr;
+    setHeldTurnDirection(0);
+}
 
-        bUpdatePositions = true;
-    } else if (currentLeftPosition > targetLeftPosition) {
-        currentLeftPosition -= 35;
+void GuiIconGrid::setDragTarget(int32_t slot) {
+    if (slot == dragTargetSlot) {
+        return;
+    }
+    //! the target is highlighted like the selection, the old one gets its own state back
+    if (dragTargetSlot >= 0 && (uint32_t) dragTargetSlot < slotWidgets.size() && slotWidgets[dragTargetSlot] != nullptr) {
+        SlotWidget *widget = slotWidgets[dragTargetSlot];
+        widget->image->setSelected(widget->titleId != 0 && widget->titleId == model.getSelected());
+    }
+    if (slot >= 0 && (uint32_t) slot < slotWidgets.size() && slotWidgets[slot] != nullptr) {
+        slotWidgets[slot]->image->setSelected(true);
+    }
+    dragTargetSlot = slot;
+}
 
-        if (currentLeftPosition < targetLeftPosition)
-            currentLeftPosition = targetLeftPosition;
+void GuiIconGrid::process() {
+    if (currentlyHeld != nullptr && heldWidget == nullptr) {
+        pickUpHeldButton();
+    }
+    if (currentlyHeld != nullptr && !currentlyHeld->isStateSet(GuiElement::STATE_HELD)) {
+        dropHeldButton();
+    }
 
-        bUpdatePositions = true;
+    //! the handlers of the model signals change the page from the threads of the GameList
+    model.lock();
+    if (currentLeftPosition != targetLeftPosition) {
+        //! the target is reached at the deadline of the animation however many frames it took
+        currentLeftPosition = lroundf(scrollAnimation.update(Animation::Clock::now()));
+
+        //! the buttons stay where they are inside the page frame
+        pageFrame.setPosition(currentLeftPosition, 0);
+        updateVisiblePages();
     }
 
     if (bUpdatePositions) {
         bUpdatePositions = false;
         updateButtonPositions();
     }
-    gameLaunchTimer++;
+    model.unlock();
+    applyDirtySlots();
 
     GuiFrame::process();
 }
 
 void GuiIconGrid::update(GuiController *c) {
     GuiFrame::update(c);
+    if (isStateSet(STATE_DISABLED) && parentElement) {
+        return;
+    }
+    updateHitWidgets(c);
 }
 
-void GuiIconGrid::updateButtonPositions() {
-    positionMutex.lock();
-    arrowRightButton.setState(GuiElement::STATE_DISABLED);
-    arrowRightButton.setVisible(false);
-    arrowLeftButton.setState(GuiElement::STATE_DISABLED);
-    arrowLeftButton.setVisible(false);
-
-    int32_t col = 0, row = 0, listOff = 0;
-
-    // create an empty vector of pairs
-    std::vector<std::pair<uint64_t, GameInfoContainer *>> vec;
-
-    containerMutex.lock();
-
-    // copy key-value pairs from the map to the vector
-    std::copy(gameInfoContainers.begin(), gameInfoContainers.end(), std::back_inserter<std::vector<std::pair<uint64_t, GameInfoContainer *>>>(vec));
-
-    containerMutex.unlock();
+void GuiIconGrid::updateHitWidgets(GuiController *c) {
+    if (c->chanIdx < 0 || c->chanIdx >= MAX_CONTROLLERS) {
+        return;
+    }
 
-    for (auto const &x : vec) {
-        if (x.second->button == currentlyHeld) {
-            currentlyHeldTitleId = x.first;
+    model.lock();
+    SlotWidget *hit = nullptr;
+    if (c->data.validPointer) {
+        int32_t slot = layout.getSlotAt(c->data.x - pageFrame.getCenterX(), c->data.y - pageFrame.getCenterY());
+        if (slot >= 0 && (uint32_t) slot < slotWidgets.size() && slotWidgets[slot] != nullptr && slotWidgets[slot]->attached) {
+            hit = slotWidgets[slot];
         }
-        remove(x.second->button);
     }
 
-    for (auto const &x : emptyButtons) {
-        remove(x);
+    //! the widget pointed at before has to clear its selected state
+    SlotWidget *last = lastHit[c->chanIdx];
+    if (last != nullptr && last != hit) {
+        last->button->update(c);
     }
-
-    if (sortByName) {
-        std::sort(vec.begin(), vec.end(),
-                  [](const std::pair<uint64_t, GameInfoContainer *> &l, const std::pair<uint64_t, GameInfoContainer *> &r) {
-                      if (l.second != r.second)
-                          return l.second->info->name.compare(r.second->info->name) < 0;
-
-                      return l.first < r.first;
-                  });
+    if (hit != nullptr) {
+        hit->button->update(c);
     }
-
-    // TODO somehow be able to adjust the positions.
-
-    //position.clear();
-    for (uint32_t i = 0; i < position.size(); i++) {
-        if (position[i] == currentlyHeldTitleId) {
-            currentlyHeldPosition = i;
-            position[i]           = 0;
-        }
+    //! the dragged icon is not in a slot but has to see the release
+    if (currentlyHeld != nullptr && (hit == nullptr || hit->button != currentlyHeld) && (last == nullptr || last->button != currentlyHeld)) {
+        currentlyHeld->update(c);
     }
+    lastHit[c->chanIdx] = hit;
+    model.unlock();
+}
 
-    uint32_t elementSize = position.size();
-    uint32_t pages       = (elementSize / (MAX_COLS * MAX_ROWS)) + 1;
-    if (elementSize % (MAX_COLS * MAX_ROWS) == 0) {
-        pages--;
-    }
+void GuiIconGrid::updateButtonPositions() {
+    model.lock();
+    arrowRightButton.setState(GuiElement::STATE_DISABLED);
+    arrowRightButton.setVisible(false);
+    arrowLeftButton.setState(GuiElement::STATE_DISABLED);
+    arrowLeftButton.setVisible(false);
 
-    uint32_t emptyIconUse = 0;
+    uint32_t pages = model.getPageCount(layout.getSlotsPerPage());
 
     if (curPage < 0) {
         curPage = 0;
@@ -645,7 +641,13 @@ void GuiIconGrid::updateButtonPositions() {
         curPage = 0;
     }
 
-    targetLeftPosition = -curPage * getWidth();
+    int32_t newTargetLeftPosition = -curPage * getWidth();
+    if (newTargetLeftPosition != targetLeftPosition) {
+        targetLeftPosition = newTargetLeftPosition;
+        scrollAnimation.start(targetLeftPosition, SCROLL_TIME, EASE_OUT_CUBIC, Animation::Clock::now());
+        //! the icons of the target page can be loaded while the scroll is still running
+        viewTargetChanged(this, curPage * layout.getSlotsPerPage(), (curPage + 1) * layout.getSlotsPerPage());
+    }
 
     if ((uint32_t) curPage < (pages - 1)) {
         arrowRightButton.clearState(GuiElement::STATE_DISABLED);
@@ -657,80 +659,94 @@ void GuiIconGrid::updateButtonPositions() {
         arrowLeftButton.setVisible(true);
         bringToFront(&arrowLeftButton);
     }
+    //! the icons are drawn above the arrows
+    bringToFront(&pageFrame);
+
+    pageFrame.setPosition(currentLeftPosition, 0);
+    updateVisiblePages();
+    pageCount = model.getPageCount(layout.getSlotsPerPage());
+    model.unlock();
+}
 
+void GuiIconGrid::updateVisiblePages() {
+    uint32_t pages     = model.getPageCount(layout.getSlotsPerPage());
     uint32_t startPage = -(currentLeftPosition / getWidth());
     uint32_t endPage   = startPage;
 
-    if (targetLeftPosition != currentLeftPosition) {
-        for (auto const &x : vec) {
-            x.second->button->setHoldable(false);
-        }
+    bool isScrolling = (targetLeftPosition != currentLeftPosition);
+    if (isScrolling) {
         endPage++;
         if (endPage > pages) {
             endPage = pages;
         }
-    } else {
-        for (auto const &x : vec) {
-            x.second->button->setHoldable(true);
-        }
     }
-    uint32_t startValue = startPage * (MAX_COLS * MAX_ROWS);
-
-    positionButtons.clear();
-    for (uint32_t i = 0; i < startValue; i++) {
-        positionButtons.push_back(nullptr);
-    }
-
-    for (uint32_t i = startPage * (MAX_COLS * MAX_ROWS); i < (endPage + 1) * (MAX_COLS * MAX_ROWS); i++) {
-        listOff            = i / (MAX_COLS * MAX_ROWS);
-        GuiButton *element = nullptr;
-        float posX         = currentLeftPosition + listOff * width + (col * (noIcon.getWidth() + noIcon.getWidth() * 0.5f) - (MAX_COLS * 0.5f - 0.5f) * (noIcon.getWidth() + noIcon.getWidth() * 0.5f));
-        float posY         = -row * (noIcon.getHeight() + noIcon.getHeight() * 0.5f) + (MAX_ROWS * 0.5f - 0.5f) * (noIcon.getHeight() + noIcon.getHeight() * 0.5f) + 30.0f;
-
-        if (i < position.size()) {
-            uint64_t titleID = position.at(i);
-            if (titleID > 0) {
-                GameInfoContainer *container = nullptr;
-                containerMutex.lock();
-                if (gameInfoContainers.find(titleID) != gameInfoContainers.end()) {
-                    container = gameInfoContainers[titleID];
-                }
-                containerMutex.unlock();
-                if (container != nullptr) {
-                    element = container->button;
-                }
-            }
+
+    //! one page ahead is bound, so it is ready when it scrolls into view
+    uint32_t firstBound = startPage;
+    uint32_t lastBound  = endPage;
+    if (targetLeftPosition > currentLeftPosition) {
+        if (firstBound > 0) {
+            firstBound--;
         }
+    } else if (lastBound + 1 < pages) {
+        lastBound++;
+    }
+    layout.setVisiblePages(firstBound, lastBound);
+
+    //! empty slots of the shown page can be drag targets
+    if (!isScrolling) {
+        model.grow((endPage + 1) * layout.getSlotsPerPage());
+    }
+
+    uint32_t newShownFirst = startPage * layout.getSlotsPerPage();
+    uint32_t newShownEnd   = (endPage + 1) * layout.getSlotsPerPage();
+    if (isScrolling != scrolling || newShownFirst != shownFirst || newShownEnd != shownEnd) {
+        scrolling  = isScrolling;
+        shownFirst = newShownFirst;
+        shownEnd   = newShownEnd;
 
-        if (element == nullptr) {
-            if (emptyButtons.size() <= emptyIconUse) {
-                break;
+        //! icons can't be picked up while scrolling
+        for (auto &widget : widgets) {
+            if (widget.slot < 0) {
+                continue;
             }
-            element = emptyButtons.at(emptyIconUse);
-            emptyIconUse++;
+            if (widget.titleId != 0) {
+                widget.button->setHoldable(!scrolling);
+            }
+            setWidgetAttached(&widget, (uint32_t) widget.slot >= shownFirst && (uint32_t) widget.slot < shownEnd);
         }
-        positionButtons.push_back(element);
-        element->setPosition(posX, posY);
-        append(element);
-
-        col++;
-        if (col >= MAX_COLS) {
-            col = 0;
-            row++;
+    }
+}
+
+void GuiIconGrid::applyDirtySlots() {
+    model.lock();
+    layout.takeDirty(dirtySlots);
+    if (dirtySlots.empty()) {
+        model.unlock();
+        return;
+    }
+
+    //! release the widgets first, a title can move to a slot later in the list
+    for (uint32_t slot : dirtySlots) {
+        if (slot < slotWidgets.size() && slotWidgets[slot] != nullptr) {
+            releaseWidget(slotWidgets[slot]);
         }
-        if (row >= MAX_ROWS) {
-            row = 0;
+    }
+
+    for (uint32_t slot : dirtySlots) {
+        if (!layout.isVisible(slot) || freeWidgets.empty()) {
+            continue;
         }
+        SlotWidget *widget = freeWidgets.back();
+        freeWidgets.pop_back();
+        bindWidget(widget, slot);
     }
+
+    //! the dragged icon stays on top
     if (currentlyHeld != nullptr) {
-        append(currentlyHeld);
-    }
-    if (positionButtons.size() > position.size() && targetLeftPosition == currentLeftPosition) {
-        for (uint32_t i = 0; i < positionButtons.size() - position.size(); i++) {
-            position.push_back(0);
-        }
+        pageFrame.append(currentlyHeld);
     }
-    positionMutex.unlock();
+    model.unlock();
 }
 
 void GuiIconGrid::draw(CVideo *pVideo) {
@@ -739,9 +755,7 @@ void GuiIconGrid::draw(CVideo *pVideo) {
     particleBgImage.draw(pVideo);
     pVideo->setStencilRender(false);
 
-    containerMutex.lock();
-    positionMutex.lock();
+    model.lock();
     GuiFrame::draw(pVideo);
-    positionMutex.unlock();
-    containerMutex.unlock();
+    model.unlock();
 }
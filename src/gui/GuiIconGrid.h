@@ -16,17 +16,22 @@
  ****************************************************************************/
 #pragma once
 
+#include "gui/Animation.h"
 #include "gui/GameIcon.h"
+#include "gui/GuiAtlasImage.h"
 #include "gui/GuiDragListener.h"
+#include "gui/GridLayout.h"
 #include "gui/GuiTitleBrowser.h"
+#include "gui/IconGridModel.h"
 #include "utils/AsyncExecutor.h"
 #include "utils/logger.h"
 #include <gui/GuiParticleImage.h>
-#include <map>
+#include <unordered_map>
 
 class GuiIconGrid : public GuiTitleBrowser, public sigslot::has_slots<> {
 public:
-    GuiIconGrid(int32_t w, int32_t h, uint64_t selectedTitleId, bool sortByName);
+    //! model is shared with the grid of the other screen and has to outlive the view
+    GuiIconGrid(int32_t w, int32_t h, IconGridModel &model);
 
     virtual ~GuiIconGrid();
 
@@ -34,30 +39,34 @@ public:
 
     uint64_t getSelectedGame(void);
 
+    uint32_t getCurrentPage(void);
+
     void update(GuiController *t);
 
     void draw(CVideo *pVideo);
 
     void process();
 
-    void OnGameTitleListUpdated(GameList *list);
-
-    void OnAddGameTitle(gameInfo *info);
-
-    void OnGameTitleUpdated(gameInfo *info);
-
-    void OnGameTitleAdded(gameInfo *info);
+    static constexpr uint32_t getSlotsPerPage() {
+        return MAX_COLS * MAX_ROWS;
+    }
 
 private:
     static const int32_t MAX_ROWS = 3;
     static const int32_t MAX_COLS = 5;
+    //! pages with bound widgets, the two shown while scrolling and one ahead
+    static const int32_t POOL_PAGES = 3;
+    //! the DRC and four Wii Remotes
+    static const int32_t MAX_CONTROLLERS = 5;
+    //! one page turn, the arrow repeat while an icon is dragged onto it and the double tap
+    static constexpr std::chrono::milliseconds SCROLL_TIME{450};
+    static constexpr std::chrono::milliseconds ARROW_REPEAT_TIME{500};
+    static constexpr std::chrono::milliseconds LAUNCH_TAP_TIME{500};
 
-    bool sortByName = false;
+    IconGridModel &model;
 
     GuiParticleImage particleBgImage;
 
-    GuiSound *buttonClickSound;
-
     GuiText gameTitle;
     GuiTrigger touchTrigger;
     GuiTrigger wpadTouchTrigger;
@@ -74,15 +83,14 @@ private:
     GuiButton upButton;
     GuiButton launchButton;
 
-    GuiImageData *arrowRightImageData;
-    GuiImageData *arrowLeftImageData;
-    GuiImage arrowRightImage;
-    GuiImage arrowLeftImage;
+    GuiAtlasImage arrowRightImage;
+    GuiAtlasImage arrowLeftImage;
     GuiButton arrowRightButton;
     GuiButton arrowLeftButton;
 
-    GuiImageData noIcon;
-    GuiImageData emptyIcon;
+    //! shared with the other grid through the resource cache
+    GuiImageData *noIcon;
+    GuiImageData *emptyIcon;
 
     GuiDragListener dragListener;
 
@@ -118,59 +126,106 @@ private:
 
     void OnRightArrowReleased(GuiButton *button, const GuiController *controller, GuiTrigger *trigger);
 
+    void OnModelSlotChanged(uint32_t slot);
+
+    void OnModelSelectionChanged(uint64_t titleId);
+
+    void OnModelTitleUpdated(gameInfo *info);
+
+    void OnModelTitleListChanged();
+
     void updateButtonPositions();
 
+    //! Shows the pages around currentLeftPosition, scrolling only moves pageFrame
+    void updateVisiblePages();
+
+    //! Binds widgets of the pool to the slots which changed
+    void applyDirtySlots();
+
+    //! Finds the slot under the pointer from the cell geometry and updates only its widget,
+    //! the one pointed at before and the dragged one
+    void updateHitWidgets(GuiController *c);
+
+    //! The slot of the held icon shows an empty one while it is dragged
+    void pickUpHeldButton();
+
+    void dropHeldButton();
+
+    void setHeldTurnDirection(int32_t direction);
+
+    //! Marks the slot the dragged icon is over, only the widgets of the old and new target change
+    void setDragTarget(int32_t slot);
+
     int32_t offsetForTitleId(uint64_t titleId);
 
-    uint32_t lArrowHeldCounter = 0;
-    uint32_t rArrowHeldCounter = 0;
+    RepeatTimer lArrowRepeat;
+    RepeatTimer rArrowRepeat;
+    //! direction last sent with pageTurnHeld
+    int32_t heldTurnDirection = 0;
+    //! moves currentLeftPosition to targetLeftPosition
+    Animation scrollAnimation;
+    //! a second click on the selected icon before LAUNCH_TAP_TIME launches it
+    Animation::Clock::time_point lastGameClick;
 
+    //! the page and the scroll state are guarded by the lock of the model
     int32_t curPage = 0;
     int32_t listOffset;
-    uint64_t selectedGame;
     int32_t currentLeftPosition;
     int32_t targetLeftPosition;
-    uint32_t gameLaunchTimer;
-    bool bUpdatePositions         = false;
-    GuiButton *currentlyHeld      = nullptr;
-    uint64_t currentlyHeldTitleId = 0;
-    int32_t currentlyHeldPosition = -1;
-    GuiButton *dragTarget         = nullptr;
-
-    class GameInfoContainer {
+    //! the arrows and the shown pages only need a relayout when this changes
+    uint32_t pageCount    = 0;
+    bool bUpdatePositions = false;
+    bool scrolling        = false;
+    //! whether the slots were filtered at the last titleListChanged of the model
+    bool shownFiltered       = false;
+    GuiButton *currentlyHeld = nullptr;
+    //! slot under the dragged icon, -1 drops it back where it was taken from
+    int32_t dragTargetSlot = -1;
+
+    //! A button with its icon, shows the title or the empty icon of one slot at a time
+    class SlotWidget {
     public:
-        GameInfoContainer(GuiButton *button, GameIcon *image, gameInfo *info) {
-            this->image  = image;
-            this->info   = info;
-            this->button = button;
-        }
-
-        ~GameInfoContainer() {
-            if (button != nullptr) {
-                AsyncExecutor::pushForDelete(button);
-            }
-            if (image != nullptr) {
-                AsyncExecutor::pushForDelete(image);
-            }
-        }
-
-        void updateImageData() {
-            if (image != nullptr && info != nullptr && info->imageData != nullptr) {
-                image->setImageData(info->imageData);
-            }
-        }
-
-        GameIcon *image;
-        gameInfo *info;
-        GuiButton *button;
+        GameIcon *image   = nullptr;
+        GuiButton *button = nullptr;
+        //! 0 while the empty icon is shown
+        uint64_t titleId = 0;
+        int32_t slot     = -1;
+        bool attached    = false;
     };
 
-    std::recursive_mutex positionMutex;
-    std::recursive_mutex containerMutex;
-    std::map<uint64_t, GameInfoContainer *> gameInfoContainers;
-    std::vector<uint64_t> position;
-    std::vector<GuiButton *> positionButtons;
+    SlotWidget *widgetOfButton(GuiButton *button);
+
+    void bindWidget(SlotWidget *widget, uint32_t slot);
+
+    void releaseWidget(SlotWidget *widget);
+
+    void setWidgetAttached(SlotWidget *widget, bool attach);
+
+    //! slots shown by this view, guarded by the lock of the model
+    GridLayout layout;
+    //! Holds the widgets of the shown pages, its position is the scroll offset
+    class PageFrame : public GuiFrame {
+    public:
+        PageFrame(float w, float h) : GuiFrame(w, h) {}
+
+        //! the input reaches the widgets through updateHitWidgets()
+        void update(GuiController *c) override {}
+    };
 
-    std::vector<GuiImage *> emptyIcons;
-    std::vector<GuiButton *> emptyButtons;
+    PageFrame pageFrame;
+    //! bound and unused widgets, the count depends on the view and not the library
+    std::vector<SlotWidget> widgets;
+    std::vector<SlotWidget *> freeWidgets;
+    //! reverse index of the pool for the button signals
+    std::unordered_map<GuiButton *, SlotWidget *> widgetOfButtons;
+    //! widget of each slot, nullptr outside of the bound pages
+    std::vector<SlotWidget *> slotWidgets;
+    //! set while this view drags a title of the model
+    SlotWidget *heldWidget = nullptr;
+    //! widget each controller pointed at in the last update
+    SlotWidget *lastHit[MAX_CONTROLLERS] = {};
+    //! slots of the shown pages, the bound ones are layout.getFirstVisible() to getEndVisible()
+    uint32_t shownFirst = 0;
+    uint32_t shownEnd   = 0;
+    std::vector<uint32_t> dirtySlots;
 };
@@ -14,12 +14,13 @@ public:
 
     virtual uint64_t getSelectedGame(void) = 0;
 
-    virtual void OnGameTitleListUpdated(GameList *list) = 0;
-
-    virtual void OnGameTitleUpdated(gameInfo *info) = 0;
-
-    virtual void OnGameTitleAdded(gameInfo *info) = 0;
+    //! Page the view shows or scrolls to
+    virtual uint32_t getCurrentPage(void) = 0;
 
     sigslot::signal2<GuiTitleBrowser *, uint64_t> gameLaunchClicked;
     sigslot::signal2<GuiTitleBrowser *, uint64_t> gameSelectionChanged;
+    //! first and end slot of the page a scroll lands on, sent when the scroll starts
+    sigslot::signal3<GuiTitleBrowser *, uint32_t, uint32_t> viewTargetChanged;
+    //! -1 or 1 while a held input keeps turning pages in that direction, 0 when it stops
+    sigslot::signal2<GuiTitleBrowser *, int32_t> pageTurnHeld;
 };
@@ -0,0 +1,275 @@
+#include "IconGridModel.h"
+#include "utils/logger.h"
+#include <algorithm>
+
+void IconGridModel::OnGameTitleListUpdated(GameList *list) {
+    list->lock();
+    lock();
+    clearFilter();
+    std::map<uint64_t, gameInfo *> listed;
+    for (int32_t i = 0; i < list->size(); i++) {
+        gameInfo *info = list->at(i);
+        if (info != nullptr) {
+            listed[info->titleId] = info;
+        }
+    }
+
+    // At first delete the ones that were deleted;
+    auto it = infos.begin();
+    while (it != infos.end()) {
+        if (listed.find(it->first) == listed.end()) {
+            DEBUG_FUNCTION_LINE("Removing %016llX", it->first);
+            int32_t slot = find(it->first);
+            if (slot >= 0) {
+                setSlot(slot, 0);
+            }
+            if (it->first == heldTitleId) {
+                //! the slot it was taken from stays empty
+                heldTitleId = 0;
+                heldSlot    = -1;
+            }
+            it = infos.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    //! slots restored from a session snapshot may hold titles which were never listed
+    for (uint32_t slot = 0; slot < slots.size(); slot++) {
+        if (slots[slot] != 0 && listed.find(slots[slot]) == listed.end()) {
+            setSlot(slot, 0);
+        }
+    }
+
+    for (auto const &x : listed) {
+        if (infos.find(x.first) == infos.end()) {
+            OnGameTitleAdded(x.second);
+        }
+    }
+    list->unlock();
+
+    //! the selection stays while its title is listed
+    setSelected((infos.find(selected) != infos.end()) ? selected : 0);
+    titleListChanged();
+    unlock();
+}
+
+void IconGridModel::OnGameTitleAdded(gameInfo *info) {
+    DEBUG_FUNCTION_LINE("Adding %016llX", info->titleId);
+    lock();
+    infos[info->titleId] = info;
+    if (find(info->titleId) < 0 && info->titleId != heldTitleId) {
+        add(info->titleId);
+    }
+    unlock();
+}
+
+void IconGridModel::OnGameTitleUpdated(gameInfo *info) {
+    DEBUG_FUNCTION_LINE("Updating infos of %016llX", info->titleId);
+    // keep the lock to delay the draw() of the views until the image data is ready.
+    lock();
+    titleUpdated(info);
+    unlock();
+}
+
+void IconGridModel::restore(const std::vector<uint64_t> &arranged, uint64_t selected, uint32_t page) {
+    lock();
+    clearFilter();
+    for (uint32_t slot = 0; slot < arranged.size(); slot++) {
+        //! a damaged snapshot must not put a title into two slots
+        if (arranged[slot] != 0 && find(arranged[slot]) < 0) {
+            setSlot(slot, arranged[slot]);
+        }
+    }
+    grow(arranged.size());
+    startPage = page;
+    setSelected(selected);
+    unlock();
+}
+
+gameInfo *IconGridModel::getInfo(uint64_t titleId) {
+    if (titleId == 0)
+        return nullptr;
+
+    lock();
+    auto itr       = infos.find(titleId);
+    gameInfo *info = (itr != infos.end()) ? itr->second : nullptr;
+    unlock();
+    return info;
+}
+
+void IconGridModel::setSlot(uint32_t slot, uint64_t id) {
+    lock();
+    grow(slot + 1);
+
+    uint64_t old = slots[slot];
+    if (old == id) {
+        unlock();
+        return;
+    }
+
+    if (old != 0) {
+        auto itr = slotOfId.find(old);
+        if (itr != slotOfId.end() && itr->second == slot)
+            slotOfId.erase(itr);
+    } else {
+        freeSlots--;
+    }
+
+    if (id != 0) {
+        slotOfId[id] = slot;
+    } else {
+        freeSlots++;
+    }
+
+    slots[slot] = id;
+    //! the filtered slots are compared with the arranged ones when the filter changes
+    if (!filtered) {
+        slotChanged(slot);
+    }
+    unlock();
+}
+
+uint32_t IconGridModel::add(uint64_t id) {
+    uint32_t slot = slots.size();
+    //! appending is the common case while the list is loaded
+    if (freeSlots > 0) {
+        slot = std::find(slots.begin(), slots.end(), 0) - slots.begin();
+    }
+    setSlot(slot, id);
+    return slot;
+}
+
+void IconGridModel::grow(uint32_t count) {
+    lock();
+    if (count > slots.size()) {
+        freeSlots += count - slots.size();
+        slots.resize(count, 0);
+    }
+    unlock();
+}
+
+int32_t IconGridModel::find(uint64_t id) const {
+    if (id == 0)
+        return -1;
+
+    const auto &map = filtered ? filteredSlotOfId : slotOfId;
+    auto itr        = map.find(id);
+    return (itr != map.end()) ? (int32_t) itr->second : -1;
+}
+
+void IconGridModel::setSelected(uint64_t titleId) {
+    lock();
+    selected = titleId;
+    selectionChanged(titleId);
+    unlock();
+}
+
+bool IconGridModel::pickUp(uint32_t slot) {
+    lock();
+    uint64_t id = getSlot(slot);
+    //! titles are only rearranged in the full grid
+    if (heldSlot >= 0 || id == 0 || filtered) {
+        unlock();
+        return false;
+    }
+    heldTitleId = id;
+    heldSlot    = slot;
+    setSlot(slot, 0);
+    unlock();
+    return true;
+}
+
+void IconGridModel::drop(int32_t targetSlot) {
+    lock();
+    if (heldSlot >= 0) {
+        uint64_t targetTitleId = heldTitleId;
+        if (targetSlot >= 0 && targetSlot != heldSlot) {
+            DEBUG_FUNCTION_LINE("Let's swap");
+            targetTitleId = getSlot(targetSlot);
+            setSlot(targetSlot, heldTitleId);
+            DEBUG_FUNCTION_LINE("Set position %d to title id of position %d", targetSlot, heldSlot);
+        }
+        setSlot(heldSlot, targetTitleId);
+    }
+    heldTitleId = 0;
+    heldSlot    = -1;
+    unlock();
+}
+
+void IconGridModel::setFilter(const std::vector<uint64_t> &titleIds) {
+    lock();
+    //! the matches keep their arranged order, which costs a sort of the matches and not a pass over all slots
+    std::vector<uint32_t> arranged;
+    for (uint64_t id : titleIds) {
+        auto itr = slotOfId.find(id);
+        if (itr != slotOfId.end()) {
+            arranged.push_back(itr->second);
+        }
+    }
+    std::sort(arranged.begin(), arranged.end());
+    std::vector<uint64_t> shown;
+    for (uint32_t slot : arranged) {
+        shown.push_back(slots[slot]);
+    }
+    showSlots(true, shown);
+    unlock();
+}
+
+void IconGridModel::clearFilter() {
+    lock();
+    if (filtered) {
+        std::vector<uint64_t> shown;
+        showSlots(false, shown);
+    }
+    unlock();
+}
+
+void IconGridModel::addLayout(const GridLayout *layout) {
+    lock();
+    layouts.push_back(layout);
+    unlock();
+}
+
+void IconGridModel::removeLayout(const GridLayout *layout) {
+    lock();
+    layouts.erase(std::remove(layouts.begin(), layouts.end(), layout), layouts.end());
+    unlock();
+}
+
+void IconGridModel::showSlots(bool filter, std::vector<uint64_t> &shown) {
+    const std::vector<uint64_t> &before = getShown();
+    const std::vector<uint64_t> &after  = filter ? shown : slots;
+
+    //! only the slots the views show are compared, both usually show the same pages
+    std::vector<std::pair<uint32_t, uint32_t>> ranges;
+    for (const GridLayout *layout : layouts) {
+        ranges.emplace_back(layout->getFirstVisible(), layout->getEndVisible());
+    }
+    std::sort(ranges.begin(), ranges.end());
+
+    std::vector<uint32_t> changed;
+    uint32_t compared = 0;
+    for (auto const &range : ranges) {
+        for (uint32_t i = std::max(range.first, compared); i < range.second; i++) {
+            uint64_t a = (i < before.size()) ? before[i] : 0;
+            uint64_t b = (i < after.size()) ? after[i] : 0;
+            if (a != b) {
+                changed.push_back(i);
+            }
+        }
+        compared = std::max(compared, range.second);
+    }
+
+    filtered = filter;
+    filteredSlots.swap(shown);
+    filteredSlotOfId.clear();
+    for (uint32_t i = 0; i < filteredSlots.size(); i++) {
+        filteredSlotOfId[filteredSlots[i]] = i;
+    }
+
+    for (uint32_t slot : changed) {
+        slotChanged(slot);
+    }
+    titleListChanged();
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "game/GameList.h"
+#include "gui/GridLayout.h"
+#include <gui/sigslot.h>
+#include <map>
+#include <mutex>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+//! Titles of the icon grid, their order in the slots, the selection and the dragged title.
+//! The TV and the DRC grid are views of one model, the title list is processed once and
+//! changes reach both views through the signals, which are emitted with the model locked.
+//! While a filter is set the slots hold only the matching titles, in their arranged order.
+class IconGridModel {
+public:
+    IconGridModel() {}
+
+    void OnGameTitleListUpdated(GameList *list);
+
+    void OnGameTitleAdded(gameInfo *info);
+
+    void OnGameTitleUpdated(gameInfo *info);
+
+    //! Arranges the slots and selects a title as saved in a session snapshot. Titles added
+    //! later keep the slot they had, titles which are not listed anymore leave it empty.
+    void restore(const std::vector<uint64_t> &arranged, uint64_t selected, uint32_t page);
+
+    //! Slots of the arranged order, also while a filter is set
+    const std::vector<uint64_t> &getArranged() const {
+        return slots;
+    }
+
+    //! Page the views open on
+    uint32_t getStartPage() const {
+        return startPage;
+    }
+
+    //! nullptr for unknown titles
+    gameInfo *getInfo(uint64_t titleId);
+
+    uint32_t getSlotCount() const {
+        return getShown().size();
+    }
+
+    uint32_t getPageCount(uint32_t slotsPerPage) const {
+        return (getSlotCount() + slotsPerPage - 1) / slotsPerPage;
+    }
+
+    //! 0 for empty slots and slots past the end
+    uint64_t getSlot(uint32_t slot) const {
+        return (slot < getShown().size()) ? getShown()[slot] : 0;
+    }
+
+    //! Puts id into slot of the arranged order, the grid grows with empty slots if needed
+    void setSlot(uint32_t slot, uint64_t id);
+
+    //! Adds empty slots until there are at least count
+    void grow(uint32_t count);
+
+    //! Slot of id or -1
+    int32_t find(uint64_t id) const;
+
+    void setSelected(uint64_t titleId);
+
+    uint64_t getSelected() const {
+        return selected;
+    }
+
+    //! Takes the title out of slot while it is dragged, fails if a title is dragged already
+    bool pickUp(uint32_t slot);
+
+    //! Swaps the dragged title with the one in targetSlot, a negative slot puts it back
+    void drop(int32_t targetSlot);
+
+    bool isHolding() const {
+        return heldSlot >= 0;
+    }
+
+    //! Shows only the titles in titleIds, only the slots whose title changes become dirty
+    void setFilter(const std::vector<uint64_t> &titleIds);
+
+    //! Shows the arranged order again
+    void clearFilter();
+
+    bool isFiltered() const {
+        return filtered;
+    }
+
+    //! The visible slots of layout are compared when the filter changes, the others become
+    //! dirty in the views when they are shown. The layout is read with the model locked.
+    void addLayout(const GridLayout *layout);
+
+    void removeLayout(const GridLayout *layout);
+
+    void lock() {
+        _lock.lock();
+    }
+
+    void unlock() {
+        _lock.unlock();
+    }
+
+    sigslot::signal1<uint32_t> slotChanged;
+    sigslot::signal1<uint64_t> selectionChanged;
+    sigslot::signal1<gameInfo *> titleUpdated;
+    sigslot::signal0<> titleListChanged;
+
+private:
+    //! Puts id into the first empty slot and returns it
+    uint32_t add(uint64_t id);
+
+    const std::vector<uint64_t> &getShown() const {
+        return filtered ? filteredSlots : slots;
+    }
+
+    //! Makes shown the slots and notifies the views of the slots which differ
+    void showSlots(bool filter, std::vector<uint64_t> &shown);
+
+    std::map<uint64_t, gameInfo *> infos;
+
+    std::vector<uint64_t> slots;
+    std::unordered_map<uint64_t, uint32_t> slotOfId;
+    uint32_t freeSlots = 0;
+
+    bool filtered = false;
+    std::vector<uint64_t> filteredSlots;
+    std::unordered_map<uint64_t, uint32_t> filteredSlotOfId;
+
+    std::vector<const GridLayout *> layouts;
+
+    uint64_t selected    = 0;
+    uint32_t startPage   = 0;
+    uint64_t heldTitleId = 0;
+    int32_t heldSlot     = -1;
+
+    std::recursive_mutex _lock;
+};
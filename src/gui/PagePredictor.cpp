@@ -0,0 +1,61 @@
+#include "PagePredictor.h"
+#include <algorithm>
+#include <cmath>
+
+void PagePredictor::onPageTarget(uint32_t page, Clock::time_point now) {
+    if (page == target) {
+        return;
+    }
+    if (turned) {
+        float seconds = std::max(std::chrono::duration<float>(now - lastTurn).count(), 0.05f);
+        float turn    = ((float) page - (float) target) / seconds;
+        //! a turn after a long pause starts over instead of averaging with the old speed
+        velocity = (seconds > HORIZON_SECONDS) ? turn : velocity * 0.5f + turn * 0.5f;
+    } else {
+        velocity = ((float) page > (float) target) ? 1.0f : -1.0f;
+    }
+    target   = page;
+    lastTurn = now;
+    turned   = true;
+}
+
+float PagePredictor::getVelocity(Clock::time_point now) const {
+    if (!turned) {
+        return 0.0f;
+    }
+    float idle = std::chrono::duration<float>(now - lastTurn).count();
+    if (idle <= HORIZON_SECONDS) {
+        return velocity;
+    }
+    return velocity * HORIZON_SECONDS / idle;
+}
+
+void PagePredictor::predict(uint32_t pageCount, Clock::time_point now, std::vector<uint32_t> &out) const {
+    out.clear();
+    if (pageCount == 0) {
+        return;
+    }
+    uint32_t page = std::min(target, pageCount - 1);
+    out.push_back(page);
+
+    float speed       = getVelocity(now);
+    int32_t direction = (heldDirection != 0) ? heldDirection : ((speed < 0.0f) ? -1 : 1);
+    uint32_t ahead    = 1 + std::min<uint32_t>(lroundf(std::fabs(speed) * HORIZON_SECONDS), MAX_AHEAD - 1);
+    if (heldDirection != 0) {
+        ahead = std::max(ahead, HELD_AHEAD);
+    }
+
+    //! the next page in the direction of motion, then the one behind, then further ahead
+    for (uint32_t i = 1; i <= ahead; i++) {
+        int32_t next = (int32_t) page + direction * (int32_t) i;
+        if (next >= 0 && next < (int32_t) pageCount) {
+            out.push_back(next);
+        }
+        if (i == 1) {
+            int32_t behind = (int32_t) page - direction;
+            if (behind >= 0 && behind < (int32_t) pageCount) {
+                out.push_back(behind);
+            }
+        }
+    }
+}
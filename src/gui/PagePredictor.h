@@ -0,0 +1,43 @@
+#pragma once
+
+#include "gui/Animation.h"
+#include <stdint.h>
+#include <vector>
+
+//! Guesses which pages of a grid are shown next from the pages the view scrolled to,
+//! how fast it turned them and whether a page turn is held.
+class PagePredictor {
+public:
+    typedef Animation::Clock Clock;
+
+    //! The view scrolls to page
+    void onPageTarget(uint32_t page, Clock::time_point now);
+
+    //! -1 or 1 while pages keep turning in that direction, 0 when released
+    void setHeld(int32_t direction) {
+        heldDirection = direction;
+    }
+
+    //! Pages per second, negative towards the first page. Decays while no page is turned.
+    float getVelocity(Clock::time_point now) const;
+
+    //! Replaces out with the pages most likely shown next, the target page first
+    void predict(uint32_t pageCount, Clock::time_point now, std::vector<uint32_t> &out) const;
+
+    uint32_t getTarget() const {
+        return target;
+    }
+
+private:
+    //! how far ahead the velocity looks and the most pages it adds
+    static constexpr float HORIZON_SECONDS = 1.0f;
+    static constexpr uint32_t MAX_AHEAD    = 4;
+    //! a held page turn repeats, so it always looks this far ahead
+    static constexpr uint32_t HELD_AHEAD = 3;
+
+    uint32_t target = 0;
+    float velocity  = 0.0f;
+    Clock::time_point lastTurn;
+    bool turned           = false;
+    int32_t heldDirection = 0;
+};
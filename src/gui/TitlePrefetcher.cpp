@@ -0,0 +1,97 @@
+#include "TitlePrefetcher.h"
+#include "gui/GlyphCacheWarmer.h"
+#include "utils/logger.h"
+#include <algorithm>
+
+TitlePrefetcher::TitlePrefetcher(IconGridModel &model, GameList &list, uint32_t slotsPerPage)
+    : model(model), list(list), slotsPerPage(slotsPerPage) {
+}
+
+TitlePrefetcher::~TitlePrefetcher() {
+    logStats();
+}
+
+void TitlePrefetcher::OnViewTargetChanged(GuiTitleBrowser *view, uint32_t firstSlot, uint32_t endSlot) {
+    model.lock();
+    uint32_t page = firstSlot / slotsPerPage;
+
+    auto itr = std::find_if(viewPages.begin(), viewPages.end(), [view](const std::pair<GuiTitleBrowser *, uint32_t> &entry) { return entry.first == view; });
+    if (itr != viewPages.end()) {
+        itr->second = page;
+    } else {
+        viewPages.emplace_back(view, page);
+    }
+
+    //! both views turn the page when the selection crosses its edge, it is counted once
+    if (page != predictor.getTarget()) {
+        for (uint32_t slot = firstSlot; slot < endSlot; slot++) {
+            gameInfo *info = model.getInfo(model.getSlot(slot));
+            if (info == nullptr) {
+                continue;
+            }
+            if (info->imageData != nullptr) {
+                hits++;
+            } else {
+                misses++;
+            }
+        }
+        predictor.onPageTarget(page, Animation::Clock::now());
+        request();
+    }
+    model.unlock();
+}
+
+void TitlePrefetcher::OnPageTurnHeld(GuiTitleBrowser *view, int32_t direction) {
+    model.lock();
+    predictor.setHeld(direction);
+    request();
+    model.unlock();
+}
+
+void TitlePrefetcher::OnTitlesChanged() {
+    model.lock();
+    //! the views report the page they show after the change through viewTargetChanged
+    request();
+    model.unlock();
+}
+
+void TitlePrefetcher::OnTitleUpdated(gameInfo *info) {
+    model.lock();
+    if (std::find(titleIds.begin(), titleIds.end(), info->titleId) != titleIds.end()) {
+        GlyphCacheWarmer::push(info->name);
+    }
+    model.unlock();
+}
+
+void TitlePrefetcher::logStats() {
+    uint32_t total = hits + misses;
+    DEBUG_FUNCTION_LINE("Prefetched icons: %u hits, %u misses (%u%%), %u evicted", hits, misses, total ? (hits * 100 / total) : 100, list.getEvictedIconCount());
+}
+
+void TitlePrefetcher::request() {
+    predictor.predict(model.getPageCount(slotsPerPage), Animation::Clock::now(), pages);
+    for (auto const &entry : viewPages) {
+        if (std::find(pages.begin(), pages.end(), entry.second) == pages.end()) {
+            pages.push_back(entry.second);
+        }
+    }
+
+    titleIds.clear();
+    for (uint32_t page : pages) {
+        for (uint32_t slot = page * slotsPerPage; slot < (page + 1) * slotsPerPage; slot++) {
+            uint64_t titleId = model.getSlot(slot);
+            if (titleId != 0) {
+                titleIds.push_back(titleId);
+            }
+        }
+    }
+    list.prefetchIcons(titleIds);
+
+    //! only the names which can be shown soon are rasterized, the glyph cache never shrinks
+    for (uint64_t titleId : titleIds) {
+        gameInfo *info = model.getInfo(titleId);
+        if (info != nullptr) {
+            GlyphCacheWarmer::push(info->name);
+        }
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "game/GameList.h"
+#include "gui/GuiTitleBrowser.h"
+#include "gui/IconGridModel.h"
+#include "gui/PagePredictor.h"
+#include <gui/sigslot.h>
+#include <utility>
+#include <vector>
+
+//! Requests the icons of the pages the grids are likely to show next from the GameList.
+//! Counts how many icons of a page were ready when a view started to scroll to it.
+class TitlePrefetcher : public sigslot::has_slots<> {
+public:
+    TitlePrefetcher(IconGridModel &model, GameList &list, uint32_t slotsPerPage);
+
+    virtual ~TitlePrefetcher();
+
+    //! Connected to GuiTitleBrowser::viewTargetChanged of each view
+    void OnViewTargetChanged(GuiTitleBrowser *view, uint32_t firstSlot, uint32_t endSlot);
+
+    //! Connected to GuiTitleBrowser::pageTurnHeld of each view
+    void OnPageTurnHeld(GuiTitleBrowser *view, int32_t direction);
+
+    //! The titles in the slots changed, the pages are requested again
+    void OnTitlesChanged();
+
+    //! Warms the glyphs of the name once it is loaded, if the title is on a requested page
+    void OnTitleUpdated(gameInfo *info);
+
+    uint32_t getHits() const {
+        return hits;
+    }
+
+    uint32_t getMisses() const {
+        return misses;
+    }
+
+    void logStats();
+
+private:
+    void request();
+
+    //! state is guarded by the lock of the model, which the views hold when they emit their signals
+    IconGridModel &model;
+    GameList &list;
+    uint32_t slotsPerPage;
+    PagePredictor predictor;
+    //! the page each view scrolls to, they stay loaded whatever the prediction is
+    std::vector<std::pair<GuiTitleBrowser *, uint32_t>> viewPages;
+    std::vector<uint32_t> pages;
+    std::vector<uint64_t> titleIds;
+    uint32_t hits   = 0;
+    uint32_t misses = 0;
+};
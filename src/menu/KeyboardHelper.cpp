@@ -1,4 +1,5 @@
 #include "KeyboardHelper.h"
+#include "utils/StringTools.h"
 #include "utils/logger.h"
 #include <coreinit/memdefaultheap.h>
 #include <nn/swkbd.h>
@@ -46,6 +47,8 @@ bool KeyboardHelper::openKeyboard() {
             return false;
         }
         keyboardOpen = true;
+        inputStr.clear();
+        inputChanged = false;
         return true;
     }
     return false;
@@ -55,6 +58,15 @@ std::string KeyboardHelper::getResult() {
     return resultStr;
 }
 
+bool KeyboardHelper::getInputIfChanged(std::string &out) {
+    if (!inputChanged) {
+        return false;
+    }
+    out          = inputStr;
+    inputChanged = false;
+    return true;
+}
+
 bool KeyboardHelper::checkResult() {
     if (keyboardCreated) {
         VPADStatus vpadStatus;
@@ -79,25 +91,23 @@ bool KeyboardHelper::checkResult() {
             nn::swkbd::CalcSubThreadPredict();
         }
 
-        if (nn::swkbd::IsDecideOkButton(nullptr) || nn::swkbd::IsDecideCancelButton(nullptr)) {
+        //! the text is read every frame, so the caller can react to each key
+        if (keyboardOpen) {
             const char16_t *str = nn::swkbd::GetInputFormString();
-            // Quick hack to get from a char16_t str to char for our log function
-            char logStr[128];
-            logStr[0] = 0;
-
-            for (int i = 0; i < 128; ++i) {
-                if (!str[i]) {
-                    logStr[i] = 0;
-                    break;
-                }
-
-                if (str[i] > 0x7F) {
-                    logStr[i] = '?';
-                } else {
-                    logStr[i] = str[i];
-                }
+            //! the names are indexed as UTF-8, so accents and CJK text match as typed
+            std::string input = StringTools::utf16ToUtf8(str);
+            if (input != inputStr) {
+                inputStr     = input;
+                inputChanged = true;
             }
-            this->resultStr = logStr;
+        }
+
+        bool ok     = nn::swkbd::IsDecideOkButton(nullptr);
+        bool cancel = nn::swkbd::IsDecideCancelButton(nullptr);
+        if (ok || cancel) {
+            //! cancel discards the search
+            this->resultStr = ok ? inputStr : "";
+            inputChanged    = false;
             keyboardOpen    = false;
             nn::swkbd::DisappearInputForm();
             return true;
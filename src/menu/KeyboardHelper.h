@@ -23,10 +23,15 @@ public:
 
     std::string getResult();
 
+    //! Text typed into the open keyboard, true if it changed since the last call
+    bool getInputIfChanged(std::string &out);
+
 private:
     void *workMemory      = nullptr;
     FSClient *fsClient    = nullptr;
     bool keyboardOpen     = false;
     bool keyboardCreated  = false;
     std::string resultStr = "";
+    std::string inputStr  = "";
+    bool inputChanged     = false;
 };
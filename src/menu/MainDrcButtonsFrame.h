@@ -18,14 +18,15 @@
 #define _MAIN_DRC_BUTTONS_FRAME_H_
 
 #include "gui/Gui.h"
+#include "gui/GuiAtlasImage.h"
 #include "resources/Resources.h"
+#include "resources/SfxPool.h"
 
 class MainDrcButtonsFrame : public GuiFrame, public sigslot::has_slots<> {
 public:
     MainDrcButtonsFrame(int32_t w, int32_t h)
-        : GuiFrame(w, h), buttonClickSound(Resources::GetSound("settings_click_2.mp3")), screenSwitchSound(Resources::GetSound("screenSwitchSound.mp3")),
-          switchIconData(Resources::GetImageData("layoutSwitchButton.png")), settingsIconData(Resources::GetImageData("settingsButton.png")), switchIcon(switchIconData),
-          settingsIcon(settingsIconData), switchLayoutButton(switchIcon.getWidth(), switchIcon.getHeight()), settingsButton(settingsIcon.getWidth(), settingsIcon.getHeight()),
+        : GuiFrame(w, h), screenSwitchSound(Resources::GetSound("screenSwitchSound.mp3")),
+          switchIcon("layoutSwitchButton.png"), settingsIcon("settingsButton.png"), switchLayoutButton(switchIcon.getWidth(), switchIcon.getHeight()), settingsButton(settingsIcon.getWidth(), settingsIcon.getHeight()),
           gameListFilterButton(w, h), touchTrigger(GuiTrigger::CHANNEL_1, GuiTrigger::VPAD_TOUCH),
           wpadTouchTrigger(GuiTrigger::CHANNEL_2 | GuiTrigger::CHANNEL_3 | GuiTrigger::CHANNEL_4 | GuiTrigger::CHANNEL_5, GuiTrigger::BUTTON_A),
           settingsTrigger(GuiTrigger::CHANNEL_ALL, GuiTrigger::BUTTON_ZL, true), switchLayoutTrigger(GuiTrigger::CHANNEL_ALL, GuiTrigger::BUTTON_ZR, true),
@@ -36,7 +37,6 @@ public:
         settingsButton.setTrigger(&wpadTouchTrigger);
         settingsButton.setTrigger(&settingsTrigger);
         settingsButton.setAlignment(ALIGN_LEFT | ALIGN_BOTTOM);
-        settingsButton.setSoundClick(buttonClickSound);
         settingsButton.setEffectGrow();
         settingsButton.clicked.connect(this, &MainDrcButtonsFrame::OnSettingsButtonClick);
         append(&settingsButton);
@@ -53,16 +53,12 @@ public:
         append(&switchLayoutButton);
 
         gameListFilterButton.setClickable(true);
-        gameListFilterButton.setSoundClick(buttonClickSound);
         gameListFilterButton.setTrigger(&plusTrigger);
         gameListFilterButton.clicked.connect(this, &MainDrcButtonsFrame::OnGameListFilterButtonClicked);
         append(&gameListFilterButton);
     }
 
     virtual ~MainDrcButtonsFrame() {
-        Resources::RemoveImageData(switchIconData);
-        Resources::RemoveImageData(settingsIconData);
-        Resources::RemoveSound(buttonClickSound);
         Resources::RemoveSound(screenSwitchSound);
     }
 
@@ -72,6 +68,7 @@ public:
 
 private:
     void OnSettingsButtonClick(GuiButton *button, const GuiController *controller, GuiTrigger *) {
+        SfxPool::Play(RESOURCE_ID("settings_click_2.mp3"));
         settingsButtonClicked(this);
     }
 
@@ -80,15 +77,13 @@ private:
     }
 
     void OnGameListFilterButtonClicked(GuiButton *button, const GuiController *controller, GuiTrigger *) {
+        SfxPool::Play(RESOURCE_ID("settings_click_2.mp3"));
         gameListFilterClicked(this);
     }
 
-    GuiSound *buttonClickSound;
     GuiSound *screenSwitchSound;
-    GuiImageData *switchIconData;
-    GuiImageData *settingsIconData;
-    GuiImage switchIcon;
-    GuiImage settingsIcon;
+    GuiAtlasImage switchIcon;
+    GuiAtlasImage settingsIcon;
 
     GuiButton switchLayoutButton;
     GuiButton settingsButton;
@@ -16,21 +16,26 @@
  ****************************************************************************/
 #include "MainWindow.h"
 #include "Application.h"
+#include "common/common.h"
 #include "utils/StringTools.h"
 #include "utils/logger.h"
 
 #include "GameSplashScreen.h"
+#include "fs/FSUtils.h"
 #include "gui/GuiIconGrid.h"
 #include "gui/GuiTitleBrowser.h"
 #include "resources/Resources.h"
 #include "utils/AsyncExecutor.h"
+#include <algorithm>
 #include <coreinit/title.h>
 #include <future>
+#include <gx2/event.h>
 #include <nn/acp/title.h>
 #include <sysapp/launch.h>
 
 MainWindow::MainWindow(int32_t w, int32_t h)
-    : width(w), height(h), gameClickSound(Resources::GetSound("game_click.mp3")), mainSwitchButtonFrame(nullptr), currentTvFrame(nullptr), currentDrcFrame(nullptr) {
+    : width(w), height(h), gameClickSound(Resources::GetSound("game_click.mp3")), mainSwitchButtonFrame(nullptr), currentTvFrame(nullptr), currentDrcFrame(nullptr),
+      prefetcher(gridModel, gameList, GuiIconGrid::getSlotsPerPage()) {
     for (int32_t i = 0; i < 4; i++) {
         std::string filename = StringTools::strfmt("player%i_point.png", i + 1);
         pointerImgData[i]    = Resources::GetImageData(filename.c_str());
@@ -38,11 +43,19 @@ MainWindow::MainWindow(int32_t w, int32_t h)
         pointerImg[i]->setScale(1.5f);
         pointerValid[i] = false;
     }
-    SetupMainView();
+    startTime = std::chrono::steady_clock::now();
     gameList.titleListChanged.connect(this, &MainWindow::OnGameTitleListChanged);
     gameList.titleUpdated.connect(this, &MainWindow::OnGameTitleUpdated);
     gameList.titleAdded.connect(this, &MainWindow::OnGameTitleAdded);
-    AsyncExecutor::execute([&] { gameList.load(); });
+    //! the grids open on the page of the snapshot, so it is restored before they are created
+    restoredSession = RestoreSession();
+    SetupMainView();
+    if (restoredSession) {
+        uint32_t first = gridModel.getStartPage() * GuiIconGrid::getSlotsPerPage();
+        prefetcher.OnViewTargetChanged(currentTvFrame, first, first + GuiIconGrid::getSlotsPerPage());
+        prefetcher.OnViewTargetChanged(currentDrcFrame, first, first + GuiIconGrid::getSlotsPerPage());
+    }
+    gameList.loadAsync();
 }
 
 MainWindow::~MainWindow() {
@@ -87,6 +100,19 @@ void MainWindow::updateEffects() {
     }
 }
 
+void MainWindow::freeEvictedIcons() {
+    gameList.takeEvictedIcons(evictedIcons);
+    if (evictedIcons.empty()) {
+        return;
+    }
+    //! the frames drawn so far may still sample them
+    GX2DrawDone();
+    for (auto const &imageData : evictedIcons) {
+        delete imageData;
+    }
+    evictedIcons.clear();
+}
+
 void MainWindow::process() {
     //! dont read behind the initial elements in case one was added
     uint32_t tvSize  = tvElements.size();
@@ -108,37 +134,137 @@ void MainWindow::process() {
         }
     }
 
+    if (!firstInteractiveSeen && interactiveCheckPending.exchange(false)) {
+        CheckFirstInteractiveFrame();
+    }
+
     if (keyboardInstance != nullptr) {
+        std::string input;
         if (keyboardInstance->checkResult()) {
             std::string result = keyboardInstance->getResult();
+            OnSearchInput(result);
 
             currentTvFrame->clearState(GuiElement::STATE_DISABLED);
             currentDrcFrame->clearState(GuiElement::STATE_DISABLED);
             mainSwitchButtonFrame->clearState(GuiElement::STATE_DISABLED);
+        } else if (keyboardInstance->getInputIfChanged(input)) {
+            //! the grids are filtered while typing
+            OnSearchInput(input);
+        }
+    }
+}
+
+void MainWindow::OnSearchInput(const std::string &query) {
+    if (query.empty()) {
+        gridModel.clearFilter();
+        prefetcher.OnTitlesChanged();
+        return;
+    }
+    gameList.search(query, searchResults);
+    gridModel.setFilter(searchResults);
+    prefetcher.OnTitlesChanged();
+}
+
+bool MainWindow::RestoreSession() {
+    SessionSnapshot snapshot;
+    if (!snapshot.load(SESSION_SNAPSHOT_PATH)) {
+        return false;
+    }
+    DEBUG_FUNCTION_LINE("Restoring page %u of the last session, %u slots", snapshot.page, snapshot.slots.size());
+    //! the slots are arranged first, so the restored titles are not appended to the first free ones
+    gridModel.restore(snapshot.slots, snapshot.selected, snapshot.page);
+    gameList.restore(snapshot);
+    return true;
+}
+
+void MainWindow::SaveSession() {
+    //! the splash screens of both screens finish, the session is saved once
+    if (launchingView == nullptr) {
+        return;
+    }
+    SessionSnapshot snapshot;
+    uint32_t page = launchingView->getCurrentPage();
+    launchingView = nullptr;
+
+    gameList.lock();
+    gridModel.lock();
+    snapshot.slots    = gridModel.getArranged();
+    snapshot.selected = gridModel.getSelected();
+    snapshot.page     = page;
+    //! the pages of a filtered view differ from the arranged order, the next start opens the page of the selection
+    if (gridModel.isFiltered()) {
+        auto itr      = std::find(snapshot.slots.begin(), snapshot.slots.end(), snapshot.selected);
+        snapshot.page = (itr != snapshot.slots.end()) ? (itr - snapshot.slots.begin()) / GuiIconGrid::getSlotsPerPage() : 0;
+    }
+
+    std::vector<uint64_t> titleIds;
+    for (uint32_t slot = snapshot.page * GuiIconGrid::getSlotsPerPage(); slot < (snapshot.page + 1) * GuiIconGrid::getSlotsPerPage() && slot < snapshot.slots.size(); slot++) {
+        titleIds.push_back(snapshot.slots[slot]);
+    }
+    titleIds.push_back(snapshot.selected);
+    for (uint64_t titleId : titleIds) {
+        gameInfo *info = gridModel.getInfo(titleId);
+        if (info != nullptr && std::none_of(snapshot.titles.begin(), snapshot.titles.end(), [titleId](const SessionSnapshot::Title &t) { return t.titleId == titleId; })) {
+            snapshot.titles.push_back({info->titleId, (uint32_t) info->appType, info->name, info->gamePath});
+        }
+    }
+    gridModel.unlock();
+    gameList.unlock();
+
+    FSUtils::CreateSubfolder(SESSION_SNAPSHOT_DIR);
+    if (!snapshot.save(SESSION_SNAPSHOT_PATH)) {
+        DEBUG_FUNCTION_LINE("Failed to save the session snapshot");
+    }
+}
+
+void MainWindow::CheckFirstInteractiveFrame() {
+    gridModel.lock();
+    uint32_t first = gridModel.getStartPage() * GuiIconGrid::getSlotsPerPage();
+    uint32_t shown = 0;
+    bool ready     = true;
+    for (uint32_t slot = first; slot < first + GuiIconGrid::getSlotsPerPage(); slot++) {
+        uint64_t titleId = gridModel.getSlot(slot);
+        if (titleId == 0) {
+            continue;
+        }
+        //! a title showing the placeholder is not ready yet
+        gameInfo *info = gridModel.getInfo(titleId);
+        if (info == nullptr || info->imageData == nullptr) {
+            ready = false;
         } else {
+            shown++;
         }
     }
+    gridModel.unlock();
+
+    if (ready && shown > 0) {
+        firstInteractiveSeen = true;
+        uint32_t ms          = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+        DEBUG_FUNCTION_LINE("First interactive frame after %u ms, %u titles on page %u (%s)", ms, shown, gridModel.getStartPage(),
+                            restoredSession ? "session snapshot" : "enumeration");
+    } else if (ready && titlesEnumerated) {
+        //! the page of the snapshot is empty or past the end of the enumerated list
+        firstInteractiveSeen = true;
+        DEBUG_FUNCTION_LINE("No titles on page %u, the first interactive frame is not measured", gridModel.getStartPage());
+    }
 }
 
+//! the grids of both screens are views of gridModel and only process the titles once
 void MainWindow::OnGameTitleListChanged(GameList *list) {
-    currentTvFrame->OnGameTitleListUpdated(list);
-    if (currentTvFrame != currentDrcFrame) {
-        currentDrcFrame->OnGameTitleListUpdated(list);
-    }
+    gridModel.OnGameTitleListUpdated(list);
+    prefetcher.OnTitlesChanged();
+    titlesEnumerated        = true;
+    interactiveCheckPending = true;
 }
 
 void MainWindow::OnGameTitleUpdated(gameInfo *info) {
-    currentTvFrame->OnGameTitleUpdated(info);
-    if (currentTvFrame != currentDrcFrame) {
-        currentDrcFrame->OnGameTitleUpdated(info);
-    }
+    gridModel.OnGameTitleUpdated(info);
+    prefetcher.OnTitleUpdated(info);
+    interactiveCheckPending = true;
 }
 
 void MainWindow::OnGameTitleAdded(gameInfo *info) {
-    currentTvFrame->OnGameTitleAdded(info);
-    if (currentTvFrame != currentDrcFrame) {
-        currentDrcFrame->OnGameTitleAdded(info);
-    }
+    gridModel.OnGameTitleAdded(info);
 }
 
 void MainWindow::update(GuiController *controller) {
@@ -219,7 +345,7 @@ void MainWindow::drawTv(CVideo *video) {
 }
 
 void MainWindow::SetupMainView() {
-    currentTvFrame = new GuiIconGrid(width, height, 0, true);
+    currentTvFrame = new GuiIconGrid(width, height, gridModel);
 
     currentTvFrame->setEffect(EFFECT_FADE, 10, 255);
     currentTvFrame->setState(GuiElement::STATE_DISABLED);
@@ -227,30 +353,30 @@ void MainWindow::SetupMainView() {
 
     appendTv(currentTvFrame);
 
-    currentDrcFrame = new GuiIconGrid(width, height, 0, false);
+    currentDrcFrame = new GuiIconGrid(width, height, gridModel);
     currentDrcFrame->setEffect(EFFECT_FADE, 10, 255);
     currentDrcFrame->setState(GuiElement::STATE_DISABLED);
     currentDrcFrame->effectFinished.connect(this, &MainWindow::OnOpenEffectFinish);
 
+    currentTvFrame->viewTargetChanged.connect(&prefetcher, &TitlePrefetcher::OnViewTargetChanged);
+    currentTvFrame->pageTurnHeld.connect(&prefetcher, &TitlePrefetcher::OnPageTurnHeld);
+    currentDrcFrame->viewTargetChanged.connect(&prefetcher, &TitlePrefetcher::OnViewTargetChanged);
+    currentDrcFrame->pageTurnHeld.connect(&prefetcher, &TitlePrefetcher::OnPageTurnHeld);
+
     if (currentTvFrame != currentDrcFrame) {
         currentDrcFrame->setEffect(EFFECT_FADE, 10, 255);
         currentDrcFrame->setState(GuiElement::STATE_DISABLED);
         currentDrcFrame->effectFinished.connect(this, &MainWindow::OnOpenEffectFinish);
     }
 
-    //! reconnect only to DRC game selection change
-    currentTvFrame->gameSelectionChanged.disconnect(this);
-    currentDrcFrame->gameSelectionChanged.disconnect(this);
+    //! the selection is shared through gridModel, only launches are handled here
     currentTvFrame->gameLaunchClicked.disconnect(this);
     currentDrcFrame->gameLaunchClicked.disconnect(this);
 
-
     if (currentTvFrame != currentDrcFrame) {
-        currentTvFrame->gameSelectionChanged.connect(this, &MainWindow::OnGameSelectionChange);
         currentTvFrame->gameLaunchClicked.connect(this, &MainWindow::OnGameLaunchSplashScreen);
     }
 
-    currentDrcFrame->gameSelectionChanged.connect(this, &MainWindow::OnGameSelectionChange);
     currentDrcFrame->gameLaunchClicked.connect(this, &MainWindow::OnGameLaunchSplashScreen);
 
     mainSwitchButtonFrame = new MainDrcButtonsFrame(width, height);
@@ -327,15 +453,10 @@ void MainWindow::OnLayoutSwitchEffectFinish(GuiElement *element) {
 
     mainSwitchButtonFrame->clearState(GuiElement::STATE_DISABLED);
 
-    //! reconnect only to DRC game selection change
-    currentTvFrame->gameSelectionChanged.disconnect(this);
-    currentDrcFrame->gameSelectionChanged.disconnect(this);
     currentTvFrame->gameLaunchClicked.disconnect(this);
     currentDrcFrame->gameLaunchClicked.disconnect(this);
 
-    currentTvFrame->gameSelectionChanged.connect(this, &MainWindow::OnGameSelectionChange);
     currentTvFrame->gameLaunchClicked.connect(this, &MainWindow::OnGameLaunchSplashScreen);
-    currentDrcFrame->gameSelectionChanged.connect(this, &MainWindow::OnGameSelectionChange);
     currentDrcFrame->gameLaunchClicked.connect(this, &MainWindow::OnGameLaunchSplashScreen);
 }
 
@@ -355,19 +476,9 @@ void MainWindow::OnCloseEffectFinish(GuiElement *element) {
 void MainWindow::OnSettingsButtonClicked(GuiElement *element) {
 }
 
-void MainWindow::OnGameSelectionChange(GuiTitleBrowser *element, uint64_t selectedIdx) {
-    if (!currentDrcFrame || !currentTvFrame)
-        return;
-
-    if (element == currentDrcFrame && currentDrcFrame != currentTvFrame) {
-        currentTvFrame->setSelectedGame(selectedIdx);
-    } else if (element == currentTvFrame && currentDrcFrame != currentTvFrame) {
-        currentDrcFrame->setSelectedGame(selectedIdx);
-    }
-}
-
 void MainWindow::OnGameLaunchSplashScreen(GuiTitleBrowser *element, uint64_t titleID) {
     DEBUG_FUNCTION_LINE("");
+    launchingView  = element;
     gameInfo *info = gameList.getGameInfo(titleID);
     if (info != nullptr) {
         auto *splashScreenDRC = new GameSplashScreen(width, height, info, false);
@@ -393,6 +504,7 @@ void MainWindow::OnGameLaunchSplashScreenFinished(GuiElement *element, gameInfo
         return;
     }
     if (launchGame) {
+        SaveSession();
         OnGameLaunch(info->titleId);
     }
     if (element) {
@@ -21,6 +21,10 @@
 #include "MainDrcButtonsFrame.h"
 #include "game/GameList.h"
 #include "gui/GuiTitleBrowser.h"
+#include "gui/IconGridModel.h"
+#include "gui/TitlePrefetcher.h"
+#include <atomic>
+#include <chrono>
 #include <gui/Gui.h>
 #include <queue>
 #include <vector>
@@ -113,6 +117,9 @@ public:
 
     void process();
 
+    //! Deletes the icons the GameList evicted, called after the frame is drawn
+    void freeEvictedIcons();
+
     void lockGUI() {
         guiMutex.lock();
     }
@@ -134,8 +141,6 @@ private:
 
     void OnGameLaunchSplashScreen(GuiTitleBrowser *element, uint64_t titleId);
 
-    void OnGameSelectionChange(GuiTitleBrowser *element, uint64_t titleId);
-
     void OnSettingsButtonClicked(GuiElement *element);
 
     void OnLayoutSwitchClicked(GuiElement *element);
@@ -150,6 +155,16 @@ private:
 
     void OnGameTitleAdded(gameInfo *info);
 
+    void OnSearchInput(const std::string &query);
+
+    //! Shows the page of the last session before the titles are enumerated, false without a snapshot
+    bool RestoreSession();
+
+    void SaveSession();
+
+    //! Logs once how long it took until the titles of the first page and their icons could be used
+    void CheckFirstInteractiveFrame();
+
     int32_t width, height;
     std::vector<GuiElement *> drcElements;
     std::vector<GuiElement *> tvElements;
@@ -161,14 +176,30 @@ private:
     GuiTitleBrowser *currentTvFrame;
     GuiTitleBrowser *currentDrcFrame;
 
+    //! nullptr until player%i_point.png are added to data/images
     GuiImageData *pointerImgData[4];
     GuiImage *pointerImg[4];
     bool pointerValid[4];
 
     GameList gameList;
+    //! shared by the grids of both screens, destroyed after them
+    IconGridModel gridModel;
+    //! loads the icons of the pages the grids turn to next
+    TitlePrefetcher prefetcher;
+    std::vector<GuiImageData *> evictedIcons;
 
     std::recursive_mutex guiMutex;
     KeyboardHelper *keyboardInstance = nullptr;
+    std::vector<uint64_t> searchResults;
+
+    //! the view the launched title was clicked in, its page is saved once
+    GuiTitleBrowser *launchingView = nullptr;
+    std::chrono::steady_clock::time_point startTime;
+    bool restoredSession      = false;
+    bool firstInteractiveSeen = false;
+    //! set by the GameList threads, the first page is only checked again after a title changed
+    std::atomic<bool> interactiveCheckPending{true};
+    std::atomic<bool> titlesEnumerated{false};
 };
 
 #endif //_MAIN_WINDOW_H_
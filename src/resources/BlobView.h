@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdint.h>
+
+//! Read-only view of a resource in memory. It points directly at the embedded data
+//! or at the loaded override, nothing is copied and the view never owns the memory.
+class BlobView {
+public:
+    BlobView() : data(nullptr), size(0) {}
+
+    BlobView(const uint8_t *data, uint32_t size) : data(data), size(size) {}
+
+    const uint8_t *getData() const {
+        return data;
+    }
+
+    uint32_t getSize() const {
+        return size;
+    }
+
+    bool empty() const {
+        return data == nullptr || size == 0;
+    }
+
+private:
+    const uint8_t *data;
+    uint32_t size;
+};
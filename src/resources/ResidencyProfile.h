@@ -0,0 +1,43 @@
+#pragma once
+
+#include "resources/Resources.h"
+#include <stdint.h>
+
+typedef enum _ResidencyKind {
+    //! the (inflated) data, for consumers which keep pointing into it
+    RESIDENCY_BLOB,
+    //! a GuiImageData of the image cache
+    RESIDENCY_IMAGE,
+    //! the texture of the UI atlas, the id is not used
+    RESIDENCY_ATLAS,
+} ResidencyKind;
+
+enum {
+    //! created by the first caller
+    RESIDENCY_LAZY = 0,
+    //! created on worker threads before the first frame, kept while in foreground
+    RESIDENCY_WARM = 1 << 0,
+    //! dropped on RELEASE_FOREGROUND, unless something else still uses it
+    RESIDENCY_EVICT = 1 << 1,
+};
+
+typedef struct _ResidencyEntry {
+    ResourceId id;
+    ResidencyKind kind;
+    uint32_t flags;
+} ResidencyEntry;
+
+//! When the embedded assets are loaded and released, carried out by Resources::WarmUp()
+//! and Resources::EvictForBackground(). Assets not listed here are lazy.
+static const ResidencyEntry ResidencyProfile[] = {
+        //! the font lives as long as the application and keeps pointing into its data
+        {RESOURCE_ID("font.ttf"), RESIDENCY_BLOB, RESIDENCY_WARM},
+        //! placeholders of both grids and the arrows, pointer and buttons of the first frame
+        {RESOURCE_ID("noGameIcon.png"), RESIDENCY_IMAGE, RESIDENCY_WARM | RESIDENCY_EVICT},
+        {RESOURCE_ID("iconEmpty.png"), RESIDENCY_IMAGE, RESIDENCY_WARM | RESIDENCY_EVICT},
+        {-1, RESIDENCY_ATLAS, RESIDENCY_WARM | RESIDENCY_EVICT},
+        //! the audio starts after the first frame, the sound effects are decoded by SfxPool
+        {RESOURCE_ID("bgMusic.ogg"), RESIDENCY_BLOB, RESIDENCY_LAZY},
+        {RESOURCE_ID("button_click.mp3"), RESIDENCY_BLOB, RESIDENCY_LAZY | RESIDENCY_EVICT},
+        {RESOURCE_ID("settings_click_2.mp3"), RESIDENCY_BLOB, RESIDENCY_LAZY | RESIDENCY_EVICT},
+};
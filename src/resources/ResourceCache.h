@@ -0,0 +1,143 @@
+#pragma once
+
+#include "resources/filelist_ids.h"
+#include <array>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <stdint.h>
+#include <unordered_map>
+
+//! Reference counted objects created from the embedded resources, one per resource id.
+//! Acquire and release are O(1) and may be called from any thread. Released objects
+//! can be kept alive for a while so toggling between views does not recreate them.
+//! The counts live in a slot per id and Release finds the slot through a map from the
+//! object, so callers keep the plain pointers they used before.
+template<typename T>
+class ResourceCache {
+public:
+    typedef T *(*CreateFunc)(int32_t id);
+    typedef void (*DestroyFunc)(T *object);
+
+    ResourceCache(CreateFunc create, DestroyFunc destroy, uint32_t keepAlive = 0)
+        : create(create), destroy(destroy), keepAlive(keepAlive) {
+    }
+
+    //! Destroys nothing, the caches are static and destroying may need the AsyncExecutor,
+    //! which is gone by then. The owner trims them before the executor is destroyed.
+    ~ResourceCache() {}
+
+    T *Acquire(int32_t id) {
+        if (id < 0 || id >= RECOURCE_COUNT)
+            return nullptr;
+
+        std::unique_lock<std::mutex> lock(mutex);
+        Slot &slot = slots[id];
+        //! a concurrent Acquire of the same id shares the object which is being created
+        created.wait(lock, [&slot] { return !slot.creating; });
+        if (slot.object == nullptr) {
+            //! created unlocked, so different resources can be loaded in parallel
+            slot.creating = true;
+            lock.unlock();
+            T *object = create(id);
+            lock.lock();
+            slot.creating = false;
+            created.notify_all();
+            if (object == nullptr)
+                return nullptr;
+            slot.object    = object;
+            owners[object] = id;
+        } else if (slot.idle) {
+            idleList.erase(slot.idlePos);
+            slot.idle = false;
+        }
+        slot.refCount++;
+        return slot.object;
+    }
+
+    //! Returns false if the object does not belong to this cache
+    bool Release(T *object) {
+        if (object == nullptr)
+            return false;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto itr = owners.find(object);
+        if (itr == owners.end())
+            return false;
+
+        Slot &slot = slots[itr->second];
+        if (slot.refCount == 0 || --slot.refCount > 0)
+            return true;
+
+        if (keepAlive == 0) {
+            Destroy(itr->second);
+            return true;
+        }
+
+        idleList.push_front(itr->second);
+        slot.idle    = true;
+        slot.idlePos = idleList.begin();
+        while (idleList.size() > keepAlive) {
+            Destroy(idleList.back());
+        }
+        return true;
+    }
+
+    //! Number of released objects which are kept alive
+    void SetKeepAlive(uint32_t count) {
+        std::lock_guard<std::mutex> lock(mutex);
+        keepAlive = count;
+        while (idleList.size() > keepAlive) {
+            Destroy(idleList.back());
+        }
+    }
+
+    //! Destroys all objects which are not referenced anymore
+    void Trim() {
+        std::lock_guard<std::mutex> lock(mutex);
+        while (!idleList.empty()) {
+            Destroy(idleList.back());
+        }
+    }
+
+    uint32_t GetRefCount(int32_t id) {
+        if (id < 0 || id >= RECOURCE_COUNT)
+            return 0;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        return slots[id].refCount;
+    }
+
+private:
+    typedef struct _Slot {
+        T *object         = nullptr;
+        uint32_t refCount = 0;
+        bool idle         = false;
+        bool creating     = false;
+        std::list<int32_t>::iterator idlePos;
+    } Slot;
+
+    //! mutex must be held
+    void Destroy(int32_t id) {
+        Slot &slot = slots[id];
+        if (slot.idle) {
+            idleList.erase(slot.idlePos);
+            slot.idle = false;
+        }
+        owners.erase(slot.object);
+        destroy(slot.object);
+        slot.object   = nullptr;
+        slot.refCount = 0;
+    }
+
+    CreateFunc create;
+    DestroyFunc destroy;
+    uint32_t keepAlive;
+
+    std::mutex mutex;
+    std::condition_variable created;
+    std::array<Slot, RECOURCE_COUNT> slots;
+    std::unordered_map<T *, int32_t> owners;
+    //! most recently released first
+    std::list<int32_t> idleList;
+};
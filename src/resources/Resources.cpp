@@ -1,7 +1,11 @@
 #include "Resources.h"
+#include "ResidencyProfile.h"
+#include "UiAtlas.h"
 #include "filelist.h"
 #include "fs/FSUtils.h"
 #include "utils/AsyncExecutor.h"
+#include "utils/MemoryAccounting.h"
+#include "utils/logger.h"
 #include <gui/GuiImageData.h>
 #include <gui/GuiSound.h>
 #include <malloc.h>
@@ -13,13 +17,24 @@
 #include <iostream>
 #include <strings.h>
 #include <thread>
+#include <zlib.h>
 
 
-Resources *Resources::instance = nullptr;
+std::recursive_mutex Resources::overrideMutex;
+std::string Resources::overridePath;
+std::vector<bool> Resources::overrideChecked;
+std::mutex Resources::residentMutex;
+std::array<GuiImageData *, RECOURCE_COUNT> Resources::residentImages{};
+bool Resources::residentAtlas = false;
+//! keeps the two grid placeholder icons alive while the layout is switched
+ResourceCache<GuiImageData> Resources::imageCache(Resources::CreateImageData, Resources::DestroyImageData, 2);
+ResourceCache<GuiSound> Resources::soundCache(Resources::CreateSound, Resources::DestroyElement<GuiSound>, 0);
 
 void Resources::Clear() {
+    overrideMutex.lock();
     for (int32_t i = 0; RecourceList[i].filename != nullptr; ++i) {
         if (RecourceList[i].CustomFile) {
+            MemoryAccounting::Remove(MEMORY_OVERRIDE, RecourceList[i].CustomFileSize);
             free(RecourceList[i].CustomFile);
             RecourceList[i].CustomFile = nullptr;
         }
@@ -27,144 +42,328 @@ void Resources::Clear() {
         if (RecourceList[i].CustomFileSize != 0)
             RecourceList[i].CustomFileSize = 0;
     }
+    overridePath.clear();
+    overrideChecked.clear();
+    overrideMutex.unlock();
 
-    if (instance)
-        delete instance;
+    EvictDecompressed();
 
-    instance = nullptr;
+    //! drops the references of the warm assets, objects still in use elsewhere stay valid
+    ReleaseResident();
+    imageCache.Trim();
+    soundCache.Trim();
 }
 
-bool Resources::LoadFiles(const char *path) {
-    if (!path)
-        return false;
+void Resources::ReleaseResident() {
+    std::lock_guard<std::mutex> lock(residentMutex);
+    for (auto &image : residentImages) {
+        if (image != nullptr) {
+            RemoveImageData(image);
+            image = nullptr;
+        }
+    }
+    if (residentAtlas) {
+        UiAtlas::Release();
+        residentAtlas = false;
+    }
+}
 
-    bool result = false;
-    Clear();
+uint8_t *Resources::Decompress(const BlobView &blob, uint32_t *size) {
+    *size = 0;
+    if (!IsCompressed(blob))
+        return nullptr;
+
+    const uint8_t *data = blob.getData();
+    uLongf destSize     = ((uint32_t) data[4] << 24) | ((uint32_t) data[5] << 16) | ((uint32_t) data[6] << 8) | data[7];
+    auto *buffer        = (uint8_t *) memalign(0x40, destSize);
+    if (!buffer) {
+        DEBUG_FUNCTION_LINE("Failed to allocate %lu bytes", (unsigned long) destSize);
+        return nullptr;
+    }
 
-    for (int32_t i = 0; RecourceList[i].filename != nullptr; ++i) {
-        std::string fullpath(path);
-        fullpath += "/";
-        fullpath += RecourceList[i].filename;
+    if (uncompress(buffer, &destSize, data + COMPRESSED_HEADER_SIZE, blob.getSize() - COMPRESSED_HEADER_SIZE) != Z_OK) {
+        DEBUG_FUNCTION_LINE("Failed to inflate resource");
+        free(buffer);
+        return nullptr;
+    }
 
-        uint8_t *buffer   = nullptr;
-        uint32_t filesize = 0;
+    *size = destSize;
+    return buffer;
+}
 
-        FSUtils::LoadFileToMem(fullpath.c_str(), &buffer, &filesize);
+bool Resources::IsCompressed(const BlobView &blob) {
+    return blob.getSize() > COMPRESSED_HEADER_SIZE && memcmp(blob.getData(), "LZ01", 4) == 0;
+}
 
-        RecourceList[i].CustomFile     = buffer;
-        RecourceList[i].CustomFileSize = (uint32_t) filesize;
-        result |= (buffer != 0);
+void Resources::EvictDecompressed() {
+    for (ResourceId id = 0; id < RECOURCE_COUNT; ++id) {
+        EvictDecompressed(id);
     }
+}
 
-    return result;
+void Resources::EvictDecompressed(ResourceId id) {
+    if (id < 0 || id >= RECOURCE_COUNT)
+        return;
+
+    overrideMutex.lock();
+    if (RecourceList[id].InflatedFile) {
+        MemoryAccounting::Remove(MEMORY_EMBEDDED, RecourceList[id].InflatedFileSize);
+        free(RecourceList[id].InflatedFile);
+        RecourceList[id].InflatedFile     = nullptr;
+        RecourceList[id].InflatedFileSize = 0;
+    }
+    overrideMutex.unlock();
 }
 
-const uint8_t *Resources::GetFile(const char *filename) {
-    for (int32_t i = 0; RecourceList[i].filename != nullptr; ++i) {
-        if (strcasecmp(filename, RecourceList[i].filename) == 0) {
-            return (RecourceList[i].CustomFile ? RecourceList[i].CustomFile : RecourceList[i].DefaultFile);
+void Resources::WarmUpEntry(const ResidencyEntry &entry) {
+    auto start       = std::chrono::steady_clock::now();
+    const char *name = (entry.kind == RESIDENCY_ATLAS) ? "uiatlas" : RecourceNames[entry.id];
+    bool loaded      = true;
+
+    switch (entry.kind) {
+        case RESIDENCY_BLOB:
+            loaded = !GetBlob(entry.id).empty();
+            break;
+        case RESIDENCY_IMAGE: {
+            //! the reference is held until EvictForBackground(), a second warm up keeps it
+            GuiImageData *image = GetImageData(entry.id);
+            loaded              = (image != nullptr);
+            std::lock_guard<std::mutex> lock(residentMutex);
+            if (residentImages[entry.id] == nullptr) {
+                residentImages[entry.id] = image;
+            } else {
+                RemoveImageData(image);
+            }
+            break;
+        }
+        case RESIDENCY_ATLAS: {
+            GuiImageData *atlas = UiAtlas::Acquire();
+            std::lock_guard<std::mutex> lock(residentMutex);
+            if (!residentAtlas) {
+                residentAtlas = true;
+            } else {
+                UiAtlas::Release();
+            }
+            loaded = (atlas != nullptr);
+            break;
         }
     }
 
-    return nullptr;
+    auto time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    DEBUG_FUNCTION_LINE("Warmed up %s in %lld us%s", name, (long long) time, loaded ? "" : " (failed)");
 }
 
-uint32_t Resources::GetFileSize(const char *filename) {
-    for (int32_t i = 0; RecourceList[i].filename != nullptr; ++i) {
-        if (strcasecmp(filename, RecourceList[i].filename) == 0) {
-            return (RecourceList[i].CustomFile ? RecourceList[i].CustomFileSize : RecourceList[i].DefaultFileSize);
+void Resources::WarmUp() {
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::future<void>> workers;
+    for (const auto &entry : ResidencyProfile) {
+        if (!(entry.flags & RESIDENCY_WARM))
+            continue;
+
+        auto task = std::make_shared<std::packaged_task<void()>>([&entry]() { WarmUpEntry(entry); });
+        workers.push_back(task->get_future());
+        AsyncExecutor::execute([task] { (*task)(); });
+    }
+    for (auto &worker : workers) {
+        worker.wait();
+    }
+
+    auto time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    DEBUG_FUNCTION_LINE("Warmed up %d assets in %lld us", (int32_t) workers.size(), (long long) time);
+}
+
+void Resources::EvictForBackground() {
+    for (const auto &entry : ResidencyProfile) {
+        if (!(entry.flags & RESIDENCY_EVICT))
+            continue;
+
+        switch (entry.kind) {
+            case RESIDENCY_BLOB:
+                EvictDecompressed(entry.id);
+                break;
+            case RESIDENCY_IMAGE: {
+                std::lock_guard<std::mutex> lock(residentMutex);
+                if (residentImages[entry.id] != nullptr) {
+                    RemoveImageData(residentImages[entry.id]);
+                    residentImages[entry.id] = nullptr;
+                }
+                break;
+            }
+            case RESIDENCY_ATLAS: {
+                std::lock_guard<std::mutex> lock(residentMutex);
+                if (residentAtlas) {
+                    UiAtlas::Release();
+                    residentAtlas = false;
+                }
+                break;
+            }
         }
     }
-    return 0;
+
+    //! released ones are not kept alive for a quick re-acquire while we are in background
+    imageCache.Trim();
+    soundCache.Trim();
 }
 
-GuiImageData *Resources::GetImageData(const char *filename) {
-    if (!instance)
-        instance = new Resources;
+bool Resources::LoadFiles(const char *path) {
+    if (!path)
+        return false;
 
-    std::map<std::string, std::pair<uint32_t, GuiImageData *>>::iterator itr = instance->imageDataMap.find(std::string(filename));
-    if (itr != instance->imageDataMap.end()) {
-        itr->second.first++;
-        return itr->second.second;
-    }
+    Clear();
 
-    for (int32_t i = 0; RecourceList[i].filename != nullptr; ++i) {
-        if (strcasecmp(filename, RecourceList[i].filename) == 0) {
-            const uint8_t *buff = RecourceList[i].CustomFile ? RecourceList[i].CustomFile : RecourceList[i].DefaultFile;
-            const uint32_t size = RecourceList[i].CustomFile ? RecourceList[i].CustomFileSize : RecourceList[i].DefaultFileSize;
+    if (!FSUtils::CheckFile(path))
+        return false;
+
+    overrideMutex.lock();
+    overridePath = path;
+    overrideMutex.unlock();
 
-            if (buff == nullptr)
-                return nullptr;
+    return true;
+}
 
-            GuiImageData *image                                  = new GuiImageData(buff, size);
-            instance->imageDataMap[std::string(filename)].first  = 1;
-            instance->imageDataMap[std::string(filename)].second = image;
+BlobView Resources::LoadOverride(ResourceId index, uint8_t **owned) {
+    RecourceFile &file = RecourceList[index];
 
-            return image;
+    overrideMutex.lock();
+    if (!overridePath.empty()) {
+        if (overrideChecked.empty()) {
+            overrideChecked.resize(sizeof(RecourceList) / sizeof(RecourceList[0]), false);
         }
+
+        //! only the first access touches the file system, missing files are not checked again
+        if (!overrideChecked[index]) {
+            overrideChecked[index] = true;
+
+            std::string fullpath = overridePath + "/" + file.filename;
+            if (FSUtils::CheckFile(fullpath.c_str())) {
+                uint8_t *buffer   = nullptr;
+                uint32_t filesize = 0;
+                if (FSUtils::LoadFileToMem(fullpath.c_str(), &buffer, &filesize) > 0) {
+                    file.CustomFile     = buffer;
+                    file.CustomFileSize = filesize;
+                    MemoryAccounting::Add(MEMORY_OVERRIDE, filesize);
+                }
+            }
+        }
+    }
+    BlobView result;
+    if (file.CustomFile) {
+        result = BlobView(file.CustomFile, file.CustomFileSize);
+    } else if (file.DefaultCompressed && !file.InflatedFile) {
+        //! inflating takes a while, it is done unlocked so other files can be loaded meanwhile
+        overrideMutex.unlock();
+        uint32_t size = 0;
+        uint8_t *data = Decompress(BlobView(file.DefaultFile, file.DefaultFileSize), &size);
+        if (owned) {
+            *owned = data;
+            return BlobView(data, size);
+        }
+
+        overrideMutex.lock();
+        if (!file.InflatedFile) {
+            file.InflatedFile     = data;
+            file.InflatedFileSize = size;
+            MemoryAccounting::Add(MEMORY_EMBEDDED, size);
+        } else {
+            //! inflated by another thread at the same time
+            free(data);
+        }
+        result = BlobView(file.InflatedFile, file.InflatedFileSize);
+    } else if (file.DefaultCompressed) {
+        result = BlobView(file.InflatedFile, file.InflatedFileSize);
+    } else {
+        result = BlobView(file.DefaultFile, file.DefaultFileSize);
     }
+    overrideMutex.unlock();
 
-    return nullptr;
+    return result;
 }
 
-void Resources::RemoveImageData(GuiImageData *image) {
-    std::map<std::string, std::pair<uint32_t, GuiImageData *>>::iterator itr;
+BlobView Resources::GetBlob(const char *filename) {
+    return GetBlob(RecourceIndex(filename));
+}
 
-    for (itr = instance->imageDataMap.begin(); itr != instance->imageDataMap.end(); itr++) {
-        if (itr->second.second == image) {
-            itr->second.first--;
+BlobView Resources::GetBlob(ResourceId id) {
+    if (id < 0 || id >= RECOURCE_COUNT)
+        return BlobView();
 
-            if (itr->second.first == 0) {
-                AsyncExecutor::pushForDelete(itr->second.second);
+    return LoadOverride(id);
+}
 
-                instance->imageDataMap.erase(itr);
-            }
-            break;
-        }
-    }
+BlobView Resources::GetBlobTransient(ResourceId id, uint8_t **owned) {
+    *owned = nullptr;
+    if (id < 0 || id >= RECOURCE_COUNT)
+        return BlobView();
+
+    return LoadOverride(id, owned);
 }
 
-GuiSound *Resources::GetSound(const char *filename) {
-    if (!instance)
-        instance = new Resources;
+const uint8_t *Resources::GetFile(const char *filename) {
+    return GetBlob(filename).getData();
+}
 
-    std::map<std::string, std::pair<uint32_t, GuiSound *>>::iterator itr = instance->soundDataMap.find(std::string(filename));
-    if (itr != instance->soundDataMap.end()) {
-        itr->second.first++;
-        return itr->second.second;
-    }
+uint32_t Resources::GetFileSize(const char *filename) {
+    return GetBlob(filename).getSize();
+}
 
-    for (int32_t i = 0; RecourceList[i].filename != nullptr; ++i) {
-        if (strcasecmp(filename, RecourceList[i].filename) == 0) {
-            const uint8_t *buff = RecourceList[i].CustomFile ? RecourceList[i].CustomFile : RecourceList[i].DefaultFile;
-            const uint32_t size = RecourceList[i].CustomFile ? RecourceList[i].CustomFileSize : RecourceList[i].DefaultFileSize;
+GuiImageData *Resources::CreateImageData(int32_t id) {
+    //! the texture is a copy, the inflated image is not kept
+    uint8_t *owned = nullptr;
+    BlobView blob  = GetBlobTransient(id, &owned);
+    if (blob.empty())
+        return nullptr;
+
+    auto *image = new GuiImageData(blob.getData(), blob.getSize());
+    free(owned);
+    MemoryAccounting::Add(MEMORY_TEXTURE, MemoryAccounting::GetTextureSize(image));
+    return image;
+}
 
-            if (buff == nullptr)
-                return nullptr;
+void Resources::DestroyImageData(GuiImageData *image) {
+    MemoryAccounting::Remove(MEMORY_TEXTURE, MemoryAccounting::GetTextureSize(image));
+    DestroyElement(image);
+}
 
-            GuiSound *sound                                      = new GuiSound(buff, size);
-            instance->soundDataMap[std::string(filename)].first  = 1;
-            instance->soundDataMap[std::string(filename)].second = sound;
+GuiSound *Resources::CreateSound(int32_t id) {
+    BlobView blob = GetBlob(id);
+    if (blob.empty())
+        return nullptr;
 
-            return sound;
-        }
-    }
+    return new GuiSound(blob.getData(), blob.getSize());
+}
 
-    return nullptr;
+template<typename T>
+void Resources::DestroyElement(T *element) {
+    //! the GUI thread might still draw it this frame
+    AsyncExecutor::pushForDelete(element);
 }
 
-void Resources::RemoveSound(GuiSound *sound) {
-    std::map<std::string, std::pair<uint32_t, GuiSound *>>::iterator itr;
+GuiImageData *Resources::GetImageData(const char *filename) {
+    return GetImageData(RecourceIndex(filename));
+}
 
-    for (itr = instance->soundDataMap.begin(); itr != instance->soundDataMap.end(); itr++) {
-        if (itr->second.second == sound) {
-            itr->second.first--;
+GuiImageData *Resources::GetImageData(ResourceId id) {
+    return imageCache.Acquire(id);
+}
 
-            if (itr->second.first == 0) {
-                AsyncExecutor::pushForDelete(itr->second.second);
-                instance->soundDataMap.erase(itr);
-            }
-            break;
-        }
-    }
+void Resources::RemoveImageData(GuiImageData *image) {
+    imageCache.Release(image);
+}
+
+GuiSound *Resources::GetSound(const char *filename) {
+    return GetSound(RecourceIndex(filename));
+}
+
+GuiSound *Resources::GetSound(ResourceId id) {
+    return soundCache.Acquire(id);
+}
+
+void Resources::RemoveSound(GuiSound *sound) {
+    soundCache.Release(sound);
+}
+
+void Resources::SetKeepAlive(uint32_t images, uint32_t sounds) {
+    imageCache.SetKeepAlive(images);
+    soundCache.SetKeepAlive(sounds);
 }
@@ -1,39 +1,114 @@
 #pragma once
 
-#include <map>
+#include "resources/BlobView.h"
+#include "resources/ResourceCache.h"
+#include "resources/filelist_ids.h"
+#include <array>
+#include <mutex>
 #include <stdint.h>
 #include <string>
+#include <type_traits>
+#include <vector>
+
+//! Index of an embedded file, resolved at compile time. Unknown names fail to compile.
+#define RESOURCE_ID(name) (std::integral_constant<ResourceId, ResourceIdChecked(RecourceIndex(name))>::value)
+
+typedef int32_t ResourceId;
+
+static constexpr ResourceId ResourceIdChecked(ResourceId id) {
+    return (id >= 0) ? id : throw "unknown resource file";
+}
 
 //! forward declaration
 class GuiImageData;
 
 class GuiSound;
 
+struct _ResidencyEntry;
+
 class Resources {
 public:
+    //! Frees the overrides and all cached objects which are not in use anymore.
+    //! Must be called before the AsyncExecutor is destroyed, it deletes the objects.
     static void Clear();
 
+    //! Use the files in path instead of the embedded ones. The files are loaded on first access,
+    //! false if path does not exist.
     static bool LoadFiles(const char *path);
 
+    //! View of the override or the embedded data, without copying
+    static BlobView GetBlob(const char *filename);
+
+    static BlobView GetBlob(ResourceId id);
+
+    //! Embedded files stored compressed are inflated on first access. Views of them stay
+    //! valid until EvictDecompressed(), which may only be called once nothing uses them.
+    static void EvictDecompressed();
+
+    static void EvictDecompressed(ResourceId id);
+
+    //! Like GetBlob(), but a compressed file that is not cached is inflated into *owned,
+    //! which the caller frees. For data that is only needed while creating an object.
+    static BlobView GetBlobTransient(ResourceId id, uint8_t **owned);
+
+    //! Inflates data packed by tools/zpack.py into a new buffer, nullptr if it is not compressed
+    static uint8_t *Decompress(const BlobView &blob, uint32_t *size);
+
+    static bool IsCompressed(const BlobView &blob);
+
     static const uint8_t *GetFile(const char *filename);
 
     static uint32_t GetFileSize(const char *filename);
 
     static GuiImageData *GetImageData(const char *filename);
 
+    static GuiImageData *GetImageData(ResourceId id);
+
     static void RemoveImageData(GuiImageData *image);
 
     static GuiSound *GetSound(const char *filename);
 
+    static GuiSound *GetSound(ResourceId id);
+
     static void RemoveSound(GuiSound *sound);
 
+    //! Loads the warm assets of the ResidencyProfile on worker threads, returns once all are loaded
+    static void WarmUp();
+
+    //! Drops the assets of the ResidencyProfile which are evicted on RELEASE_FOREGROUND
+    static void EvictForBackground();
+
+    //! How many released images and sounds stay loaded for a quick re-acquire
+    static void SetKeepAlive(uint32_t images, uint32_t sounds);
+
 private:
-    static Resources *instance;
+    static const uint32_t COMPRESSED_HEADER_SIZE = 8;
+
+    static BlobView LoadOverride(ResourceId id, uint8_t **owned = nullptr);
+
+    static GuiImageData *CreateImageData(int32_t id);
+
+    static void DestroyImageData(GuiImageData *image);
+
+    static GuiSound *CreateSound(int32_t id);
+
+    static void WarmUpEntry(const _ResidencyEntry &entry);
+
+    //! Releases the warm assets held since WarmUp()
+    static void ReleaseResident();
+
+    template<typename T>
+    static void DestroyElement(T *element);
 
-    Resources() {}
+    static std::recursive_mutex overrideMutex;
+    static std::string overridePath;
+    static std::vector<bool> overrideChecked;
 
-    ~Resources() {}
+    static ResourceCache<GuiImageData> imageCache;
+    static ResourceCache<GuiSound> soundCache;
 
-    std::map<std::string, std::pair<uint32_t, GuiImageData *>> imageDataMap;
-    std::map<std::string, std::pair<uint32_t, GuiSound *>> soundDataMap;
+    //! references held for the warm assets
+    static std::mutex residentMutex;
+    static std::array<GuiImageData *, RECOURCE_COUNT> residentImages;
+    static bool residentAtlas;
 };
\ No newline at end of file
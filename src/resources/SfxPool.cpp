@@ -0,0 +1,181 @@
+#include "SfxPool.h"
+#include "utils/AsyncExecutor.h"
+#include "utils/MemoryAccounting.h"
+#include "utils/logger.h"
+#include <coreinit/cache.h>
+#include <gui/sounds/Mp3Decoder.hpp>
+#include <gui/sounds/OggDecoder.hpp>
+#include <gui/sounds/SoundHandler.hpp>
+#include <gui/sounds/Voice.h>
+#include <gui/sounds/WavDecoder.hpp>
+#include <malloc.h>
+#include <string.h>
+#include <vector>
+
+SfxPool::SfxBuffer SfxPool::effects[RECOURCE_COUNT];
+Voice *SfxPool::voices[SfxPool::MAX_VOICES];
+std::atomic<uint32_t> SfxPool::nextVoice(0);
+uint32_t SfxPool::volume = 100;
+std::mutex SfxPool::mutex;
+std::condition_variable SfxPool::preloadsDone;
+uint32_t SfxPool::runningPreloads = 0;
+
+static SoundDecoder *CreateDecoder(const uint8_t *data, uint32_t size) {
+    if (size > 4 && memcmp(data, "OggS", 4) == 0)
+        return new OggDecoder(data, size);
+    if (size > 4 && memcmp(data, "RIFF", 4) == 0)
+        return new WavDecoder(data, size);
+    return new Mp3Decoder(data, size);
+}
+
+bool SfxPool::CreateVoices() {
+    if (voices[0] != nullptr)
+        return true;
+
+    //! makes sure AX is up before voices are acquired
+    SoundHandler::instance();
+
+    for (auto &voice : voices) {
+        voice = new Voice(Voice::PRIO_MAX);
+    }
+    SetVolume(volume);
+    return true;
+}
+
+bool SfxPool::Preload(ResourceId id) {
+    if (id < 0 || id >= RECOURCE_COUNT)
+        return false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (effects[id].samples != nullptr)
+            return true;
+    }
+
+    uint8_t *owned = nullptr;
+    BlobView blob  = Resources::GetBlobTransient(id, &owned);
+    if (blob.empty() || !CreateVoices()) {
+        free(owned);
+        return false;
+    }
+
+    SoundDecoder *decoder = CreateDecoder(blob.getData(), blob.getSize());
+    if ((decoder->GetFormat() & 0xFF) != SoundDecoder::FORMAT_PCM_16_BIT) {
+        DEBUG_FUNCTION_LINE("Unsupported sample format of resource %d", id);
+        delete decoder;
+        free(owned);
+        return false;
+    }
+
+    bool stereo = (decoder->GetFormat() & SoundDecoder::CHANNELS_STEREO) != 0;
+    std::vector<int16_t> pcm;
+    uint8_t buffer[0x2000];
+    int32_t pos = 0;
+    int32_t read;
+    while ((read = decoder->Read(buffer, sizeof(buffer), pos)) > 0) {
+        pos += read;
+
+        const auto *in  = (const int16_t *) buffer;
+        uint32_t frames = read / (stereo ? 4 : 2);
+        for (uint32_t i = 0; i < frames; i++) {
+            pcm.push_back(stereo ? (int16_t) (((int32_t) in[i * 2] + in[i * 2 + 1]) / 2) : in[i]);
+        }
+    }
+
+    uint32_t sampleRate = decoder->GetSampleRate();
+    delete decoder;
+    free(owned);
+
+    if (pcm.empty())
+        return false;
+
+    uint32_t size = pcm.size() * sizeof(int16_t);
+    auto *samples = (int16_t *) memalign(0x40, size);
+    if (!samples)
+        return false;
+
+    memcpy(samples, pcm.data(), size);
+    DCFlushRange(samples, size);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (effects[id].samples != nullptr) {
+        //! preloaded meanwhile on another thread
+        free(samples);
+        return true;
+    }
+    effects[id].samples    = samples;
+    effects[id].size       = size;
+    effects[id].sampleRate = sampleRate;
+    MemoryAccounting::Add(MEMORY_SOUND, size);
+
+    DEBUG_FUNCTION_LINE("Preloaded resource %d, %d samples at %d Hz", id, pcm.size(), sampleRate);
+    return true;
+}
+
+void SfxPool::PreloadAsync(ResourceId id) {
+    if (id < 0 || id >= RECOURCE_COUNT)
+        return;
+
+    mutex.lock();
+    if (effects[id].samples != nullptr || effects[id].loading) {
+        mutex.unlock();
+        return;
+    }
+    effects[id].loading = true;
+    runningPreloads++;
+    mutex.unlock();
+
+    //! the voices need AX, they are set up on the calling thread
+    CreateVoices();
+
+    AsyncExecutor::execute([id] {
+        Preload(id);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        effects[id].loading = false;
+        runningPreloads--;
+        preloadsDone.notify_all();
+    });
+}
+
+void SfxPool::Play(ResourceId id) {
+    if (id < 0 || id >= RECOURCE_COUNT)
+        return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (effects[id].samples == nullptr)
+        return;
+
+    //! round robin, the oldest effect is cut off if all voices are busy
+    Voice *voice = voices[nextVoice.fetch_add(1) % MAX_VOICES];
+    voice->stop();
+    voice->play((const uint8_t *) effects[id].samples, effects[id].size, nullptr, 0, SoundDecoder::FORMAT_PCM_16_BIT | SoundDecoder::CHANNELS_MONO, effects[id].sampleRate);
+}
+
+void SfxPool::SetVolume(uint32_t vol) {
+    volume = vol;
+    for (auto &voice : voices) {
+        if (voice != nullptr)
+            voice->setVolume(((0x8000 * volume) / 100) << 16);
+    }
+}
+
+void SfxPool::Clear() {
+    std::unique_lock<std::mutex> lock(mutex);
+    preloadsDone.wait(lock, [] { return runningPreloads == 0; });
+
+    for (auto &voice : voices) {
+        if (voice != nullptr) {
+            voice->stop();
+            delete voice;
+            voice = nullptr;
+        }
+    }
+    for (auto &effect : effects) {
+        if (effect.samples != nullptr) {
+            MemoryAccounting::Remove(MEMORY_SOUND, effect.size);
+            free(effect.samples);
+        }
+        effect.samples = nullptr;
+        effect.size    = 0;
+    }
+}
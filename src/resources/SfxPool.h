@@ -0,0 +1,51 @@
+#pragma once
+
+#include "resources/Resources.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stdint.h>
+
+//! forward declaration
+class Voice;
+
+//! Short sound effects, decoded once to mono 16 bit PCM and played on a few
+//! preallocated voices. Play() does no decoding and no allocation.
+class SfxPool {
+public:
+    static const int32_t MAX_VOICES = 4;
+
+    //! Needs the sound handler (AX) to be initialized
+    static bool Preload(ResourceId id);
+
+    //! Decodes the effect on the AsyncExecutor, Play() skips it until it is done
+    static void PreloadAsync(ResourceId id);
+
+    static void Play(ResourceId id);
+
+    //! 0 - 100
+    static void SetVolume(uint32_t volume);
+
+    //! Waits for the preloads which are still running
+    static void Clear();
+
+private:
+    typedef struct _SfxBuffer {
+        int16_t *samples;
+        uint32_t size;
+        uint32_t sampleRate;
+        bool loading;
+    } SfxBuffer;
+
+    static bool CreateVoices();
+
+    static SfxBuffer effects[RECOURCE_COUNT];
+    static Voice *voices[MAX_VOICES];
+    static std::atomic<uint32_t> nextVoice;
+    static uint32_t volume;
+
+    //! guards effects, a preload publishes its samples while Play() may be called
+    static std::mutex mutex;
+    static std::condition_variable preloadsDone;
+    static uint32_t runningPreloads;
+};
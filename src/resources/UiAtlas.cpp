@@ -0,0 +1,64 @@
+#include "UiAtlas.h"
+#include "Resources.h"
+#include "uiatlas_layout.h"
+#include "uiatlas_tga.h"
+#include "utils/AsyncExecutor.h"
+#include "utils/MemoryAccounting.h"
+#include "utils/logger.h"
+#include <gui/GuiImageData.h>
+#include <malloc.h>
+#include <strings.h>
+
+std::mutex UiAtlas::mutex;
+GuiImageData *UiAtlas::atlas = nullptr;
+uint32_t UiAtlas::refCount   = 0;
+
+GuiImageData *UiAtlas::Acquire() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!atlas) {
+        //! the inflated image is only needed until the texture is created
+        uint32_t size = 0;
+        uint8_t *data = Resources::Decompress(BlobView(uiatlas_tga, uiatlas_tga_size), &size);
+        if (data) {
+            atlas = new GuiImageData(data, size);
+            free(data);
+        } else {
+            atlas = new GuiImageData(uiatlas_tga, uiatlas_tga_size);
+        }
+        MemoryAccounting::Add(MEMORY_TEXTURE, MemoryAccounting::GetTextureSize(atlas));
+        DEBUG_FUNCTION_LINE("Created UI atlas %dx%d", atlas->getWidth(), atlas->getHeight());
+    }
+    refCount++;
+    return atlas;
+}
+
+void UiAtlas::Release() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (refCount == 0)
+        return;
+
+    if (--refCount == 0) {
+        MemoryAccounting::Remove(MEMORY_TEXTURE, MemoryAccounting::GetTextureSize(atlas));
+        AsyncExecutor::pushForDelete(atlas);
+        atlas = nullptr;
+    }
+}
+
+const UiAtlasSprite *UiAtlas::FindSprite(const char *name) {
+    if (!name)
+        return nullptr;
+
+    for (int32_t i = 0; UiAtlasSprites[i].name != nullptr; ++i) {
+        if (strcasecmp(name, UiAtlasSprites[i].name) == 0)
+            return &UiAtlasSprites[i];
+    }
+    return nullptr;
+}
+
+uint32_t UiAtlas::GetWidth() {
+    return UIATLAS_WIDTH;
+}
+
+uint32_t UiAtlas::GetHeight() {
+    return UIATLAS_HEIGHT;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <mutex>
+#include <stdint.h>
+
+//! forward declaration
+class GuiImageData;
+
+typedef struct _UiAtlasSprite {
+    const char *name;
+    uint16_t x;
+    uint16_t y;
+    uint16_t width;
+    uint16_t height;
+} UiAtlasSprite;
+
+//! Static UI sprites packed into one texture at build time by tools/atlaspack.py
+class UiAtlas {
+public:
+    //! Texture of the whole atlas, created on first use and shared by all sprites
+    static GuiImageData *Acquire();
+
+    static void Release();
+
+    static const UiAtlasSprite *FindSprite(const char *name);
+
+    static uint32_t GetWidth();
+
+    static uint32_t GetHeight();
+
+private:
+    static std::mutex mutex;
+    static GuiImageData *atlas;
+    static uint32_t refCount;
+};
@@ -0,0 +1,78 @@
+#include "MemoryAccounting.h"
+#include "utils/logger.h"
+#include <gui/GuiImageData.h>
+
+const char *MemoryAccounting::categoryNames[MEMORY_CATEGORY_COUNT] = {"embedded", "override", "texture", "sound", "title icon", "glyph"};
+std::atomic<uint32_t> MemoryAccounting::live[MEMORY_CATEGORY_COUNT];
+std::atomic<uint32_t> MemoryAccounting::peak[MEMORY_CATEGORY_COUNT];
+//! an icon texture is 128x128 RGBA, 32 MiB are about 500 titles. A warmed glyph takes about
+//! 13 KiB at both sizes, 4 MiB are ASCII and the names of a few pages.
+std::atomic<uint32_t> MemoryAccounting::budget[MEMORY_CATEGORY_COUNT] = {
+        {4 * 1024 * 1024},
+        {8 * 1024 * 1024},
+        {4 * 1024 * 1024},
+        {2 * 1024 * 1024},
+        {32 * 1024 * 1024},
+        {4 * 1024 * 1024}};
+
+void MemoryAccounting::Add(MemoryCategory category, uint32_t bytes) {
+    if (category >= MEMORY_CATEGORY_COUNT || bytes == 0)
+        return;
+
+    uint32_t before = live[category].fetch_add(bytes);
+    uint32_t after  = before + bytes;
+
+    uint32_t oldPeak = peak[category].load();
+    while (after > oldPeak && !peak[category].compare_exchange_weak(oldPeak, after)) {
+    }
+
+    //! only warn when crossing the budget, not on every following allocation
+    uint32_t limit = budget[category].load();
+    if (limit != 0 && before <= limit && after > limit) {
+        DEBUG_FUNCTION_LINE("WARNING: %s memory exceeds its budget: %u of %u bytes", categoryNames[category], after, limit);
+    }
+}
+
+void MemoryAccounting::Remove(MemoryCategory category, uint32_t bytes) {
+    if (category >= MEMORY_CATEGORY_COUNT)
+        return;
+
+    live[category].fetch_sub(bytes);
+}
+
+void MemoryAccounting::SetBudget(MemoryCategory category, uint32_t bytes) {
+    if (category >= MEMORY_CATEGORY_COUNT)
+        return;
+
+    budget[category] = bytes;
+}
+
+uint32_t MemoryAccounting::GetBudget(MemoryCategory category) {
+    return (category < MEMORY_CATEGORY_COUNT) ? budget[category].load() : 0;
+}
+
+uint32_t MemoryAccounting::GetLive(MemoryCategory category) {
+    return (category < MEMORY_CATEGORY_COUNT) ? live[category].load() : 0;
+}
+
+uint32_t MemoryAccounting::GetPeak(MemoryCategory category) {
+    return (category < MEMORY_CATEGORY_COUNT) ? peak[category].load() : 0;
+}
+
+uint32_t MemoryAccounting::GetTextureSize(const GuiImageData *image) {
+    if (!image || !image->getTexture())
+        return 0;
+
+    return image->getTexture()->surface.imageSize;
+}
+
+void MemoryAccounting::LogStats() {
+    uint32_t total = 0;
+    for (int32_t i = 0; i < MEMORY_CATEGORY_COUNT; i++) {
+        uint32_t limit = budget[i].load();
+        DEBUG_FUNCTION_LINE("memory %-10s: %8u bytes live, %8u bytes peak, budget %u%s", categoryNames[i], live[i].load(), peak[i].load(), limit,
+                            (limit != 0 && live[i].load() > limit) ? " (exceeded)" : "");
+        total += live[i].load();
+    }
+    DEBUG_FUNCTION_LINE("memory total     : %8u bytes live", total);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+//! forward declaration
+class GuiImageData;
+
+typedef enum _MemoryCategory {
+    //! embedded files inflated by Resources
+    MEMORY_EMBEDDED,
+    //! files loaded from the override path
+    MEMORY_OVERRIDE,
+    //! textures of the embedded images and the UI atlas
+    MEMORY_TEXTURE,
+    //! decoded sound effects
+    MEMORY_SOUND,
+    //! textures of the title icons
+    MEMORY_TITLE_ICON,
+    //! glyphs rasterized ahead of time by GlyphCacheWarmer
+    MEMORY_GLYPH,
+    MEMORY_CATEGORY_COUNT
+} MemoryCategory;
+
+//! Live and peak bytes per category of the memory used by assets. Allocation sites tag
+//! what they allocate and free, a warning is logged when a category exceeds its budget.
+class MemoryAccounting {
+public:
+    static void Add(MemoryCategory category, uint32_t bytes);
+
+    static void Remove(MemoryCategory category, uint32_t bytes);
+
+    //! 0 disables the budget of the category
+    static void SetBudget(MemoryCategory category, uint32_t bytes);
+
+    static uint32_t GetBudget(MemoryCategory category);
+
+    static uint32_t GetLive(MemoryCategory category);
+
+    static uint32_t GetPeak(MemoryCategory category);
+
+    //! Size of the texture memory of an image, 0 for nullptr
+    static uint32_t GetTextureSize(const GuiImageData *image);
+
+    static void LogStats();
+
+private:
+    static const char *categoryNames[MEMORY_CATEGORY_COUNT];
+    static std::atomic<uint32_t> live[MEMORY_CATEGORY_COUNT];
+    static std::atomic<uint32_t> peak[MEMORY_CATEGORY_COUNT];
+    static std::atomic<uint32_t> budget[MEMORY_CATEGORY_COUNT];
+};
@@ -154,6 +154,39 @@ BOOL StringTools::char2wchar_t(const char *strChar, wchar_t *dest) {
     return false;
 }
 
+std::string StringTools::utf16ToUtf8(const char16_t *src) {
+    std::string result;
+    if (!src)
+        return result;
+
+    for (; *src; src++) {
+        uint32_t c = *src;
+        if (c >= 0xD800 && c <= 0xDBFF && src[1] >= 0xDC00 && src[1] <= 0xDFFF) {
+            c = 0x10000 + ((c - 0xD800) << 10) + (src[1] - 0xDC00);
+            src++;
+        } else if (c >= 0xD800 && c <= 0xDFFF) {
+            c = 0xFFFD;
+        }
+
+        if (c < 0x80) {
+            result += (char) c;
+        } else if (c < 0x800) {
+            result += (char) (0xC0 | (c >> 6));
+            result += (char) (0x80 | (c & 0x3F));
+        } else if (c < 0x10000) {
+            result += (char) (0xE0 | (c >> 12));
+            result += (char) (0x80 | ((c >> 6) & 0x3F));
+            result += (char) (0x80 | (c & 0x3F));
+        } else {
+            result += (char) (0xF0 | (c >> 18));
+            result += (char) (0x80 | ((c >> 12) & 0x3F));
+            result += (char) (0x80 | ((c >> 6) & 0x3F));
+            result += (char) (0x80 | (c & 0x3F));
+        }
+    }
+    return result;
+}
+
 int32_t StringTools::strtokcmp(const char *string, const char *compare, const char *separator) {
     if (!string || !compare)
         return -1;
@@ -162,13 +195,15 @@ int32_t StringTools::strtokcmp(const char *string, const char *compare, const ch
     strncpy(TokCopy, compare, sizeof(TokCopy));
     TokCopy[511] = '\0';
 
-    char *strTok = strtok(TokCopy, separator);
+    //! strtok_r so the directory scan workers can filter concurrently
+    char *savePtr = nullptr;
+    char *strTok  = strtok_r(TokCopy, separator, &savePtr);
 
     while (strTok != nullptr) {
         if (strcasecmp(string, strTok) == 0) {
             return 0;
         }
-        strTok = strtok(nullptr, separator);
+        strTok = strtok_r(nullptr, separator, &savePtr);
     }
 
     return -1;
@@ -178,7 +213,7 @@ int32_t StringTools::strextcmp(const char *string, const char *extension, char s
     if (!string || !extension)
         return -1;
 
-    char *ptr = strrchr(string, seperator);
+    const char *ptr = strrchr(string, seperator);
     if (!ptr)
         return -1;
 
@@ -50,6 +50,9 @@ public:
 
     static BOOL char2wchar_t(const char *src, wchar_t *dest);
 
+    //! UTF-8 of a zero terminated UTF-16 string, unpaired surrogates become U+FFFD
+    static std::string utf16ToUtf8(const char16_t *src);
+
     static int32_t strtokcmp(const char *string, const char *compare, const char *separator);
 
     static int32_t strextcmp(const char *string, const char *extension, char seperator);
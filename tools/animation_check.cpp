@@ -0,0 +1,139 @@
+/****************************************************************************
+ * Host check of Animation and RepeatTimer with irregular frames.
+ *
+ * Steps the clock by jittered frame intervals from 1 to 61 ms, as the menu
+ * sees them while icons are loaded or the SD card stalls, and checks that
+ *
+ *  - an animation only depends on the time passed: every frame shows the
+ *    value a fresh animation sampled at that time shows, the value moves
+ *    towards the target and the target is reached in the first frame after
+ *    the deadline, one long stall jumps right to it
+ *  - a new target continues from the current value
+ *  - a repeat timer fires once per interval of held time and only once
+ *    after a stall instead of catching up on every missed interval
+ *
+ *   g++ -std=c++17 -O2 -Isrc tools/animation_check.cpp src/gui/Animation.cpp -o animation_check
+ *   ./animation_check
+ ****************************************************************************/
+#include "gui/Animation.h"
+#include <cmath>
+#include <random>
+#include <stdio.h>
+
+typedef Animation::Clock Clock;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+
+static uint32_t failures = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            failures++;                                                     \
+        }                                                                   \
+    } while (0)
+
+static const float TARGET          = -1280.0f;
+static const Clock::duration SCROLL = milliseconds(450);
+
+//! 1 to 61 ms
+static Clock::duration JitteredFrame(std::mt19937 &rng) {
+    return microseconds(1000 + rng() % 60000);
+}
+
+static void CheckJitteredScroll(EasingCurve curve, std::mt19937 &rng, Clock::time_point start) {
+    Animation anim;
+    anim.jumpTo(0.0f);
+    anim.start(TARGET, SCROLL, curve, start);
+
+    Clock::time_point now = start;
+    float last            = 0.0f;
+    while (anim.isRunning()) {
+        now += JitteredFrame(rng);
+        float value = anim.update(now);
+
+        Animation sampled;
+        sampled.jumpTo(0.0f);
+        sampled.start(TARGET, SCROLL, curve, start);
+        CHECK(std::fabs(sampled.update(now) - value) < 1e-3f);
+
+        CHECK(value <= last + 1e-3f);
+        last = value;
+    }
+    CHECK(anim.getValue() == TARGET);
+    CHECK(now >= anim.getDeadline());
+    CHECK(now - anim.getDeadline() < milliseconds(61));
+
+    Animation stalled;
+    stalled.jumpTo(0.0f);
+    stalled.start(TARGET, SCROLL, curve, start);
+    CHECK(stalled.update(start + std::chrono::seconds(5)) == TARGET);
+    CHECK(!stalled.isRunning());
+}
+
+static void CheckRetarget(Clock::time_point start) {
+    Animation anim;
+    anim.jumpTo(0.0f);
+    anim.start(TARGET, milliseconds(400), EASE_OUT_CUBIC, start);
+    float mid = anim.update(start + milliseconds(100));
+    anim.start(0.0f, milliseconds(400), EASE_OUT_CUBIC, start + milliseconds(100));
+    CHECK(std::fabs(anim.update(start + milliseconds(100)) - mid) < 1e-3f);
+    CHECK(anim.update(start + milliseconds(500)) == 0.0f);
+
+    //! nothing to animate
+    anim.jumpTo(5.0f);
+    anim.start(5.0f, milliseconds(100), EASE_LINEAR, start);
+    CHECK(!anim.isRunning());
+    anim.start(7.0f, Clock::duration::zero(), EASE_LINEAR, start);
+    CHECK(!anim.isRunning() && anim.getValue() == 7.0f);
+
+    for (int32_t curve = EASE_LINEAR; curve <= EASE_IN_OUT_CUBIC; curve++) {
+        CHECK(Animation::ease((EasingCurve) curve, 0.0f) == 0.0f);
+        CHECK(std::fabs(Animation::ease((EasingCurve) curve, 1.0f) - 1.0f) < 1e-6f);
+    }
+}
+
+static void CheckJitteredRepeat(std::mt19937 &rng, Clock::time_point start) {
+    RepeatTimer timer(milliseconds(500), milliseconds(500));
+    Clock::time_point now = start;
+    uint32_t fired        = 0;
+    CHECK(!timer.poll(now));
+    while (now - start < std::chrono::seconds(5)) {
+        now += JitteredFrame(rng);
+        if (timer.poll(now)) {
+            fired++;
+        }
+    }
+    //! a repeat is late by at most one frame, which adds up over the held time
+    uint32_t due = std::chrono::duration_cast<milliseconds>(now - start).count() / 500;
+    CHECK(fired <= due && fired + 2 >= due);
+
+    Clock::time_point stall = now + std::chrono::seconds(3);
+    CHECK(timer.poll(stall));
+    CHECK(!timer.poll(stall + milliseconds(499)));
+    CHECK(timer.poll(stall + milliseconds(500)));
+
+    timer.reset();
+    CHECK(!timer.poll(stall + milliseconds(600)));
+}
+
+int main() {
+    std::mt19937 rng(3);
+    Clock::time_point start = Clock::now();
+
+    for (int32_t run = 0; run < 200; run++) {
+        for (int32_t curve = EASE_LINEAR; curve <= EASE_IN_OUT_CUBIC; curve++) {
+            CheckJitteredScroll((EasingCurve) curve, rng, start);
+        }
+        CheckJitteredRepeat(rng, start);
+    }
+    CheckRetarget(start);
+
+    if (failures > 0) {
+        printf("%u checks failed\n", failures);
+        return 1;
+    }
+    printf("all checks passed\n");
+    return 0;
+}
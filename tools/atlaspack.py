@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+#
+# Packs the UI sprites into one texture atlas at build time.
+#
+# Sprites are placed on shelves, sorted by height, width and name so the same
+# input always gives the same atlas. Every sprite gets a border of repeated edge
+# pixels to keep linear filtering from bleeding in the neighbours. Writes an
+# uncompressed TGA (see png2tga.py) and a header with the sprite rectangles.
+#
+# usage: atlaspack.py <output.tga> <output.h> <sprite.png>...
+
+import os
+import sys
+
+from png2tga import read_png, write_tga
+
+PADDING = 2
+MAX_SIZE = 2048
+
+
+def shelf_pack(sprites, width):
+    x = y = shelf = 0
+    placed = []
+    for name, w, h, _ in sprites:
+        pw, ph = w + PADDING * 2, h + PADDING * 2
+        if pw > width:
+            return None
+        if x + pw > width:
+            x = 0
+            y += shelf
+            shelf = 0
+        placed.append((name, x + PADDING, y + PADDING, w, h))
+        x += pw
+        shelf = max(shelf, ph)
+    height = (y + shelf + 7) & ~7
+    if height > MAX_SIZE:
+        return None
+    return height, placed
+
+
+def pack(sprites):
+    sprites = sorted(sprites, key=lambda s: (-s[2], -s[1], s[0].lower()))
+    best = None
+    width = 64
+    while width <= MAX_SIZE:
+        result = shelf_pack(sprites, width)
+        if result is not None:
+            height, placed = result
+            if best is None or width * height < best[0] * best[1]:
+                best = (width, height, placed)
+        width *= 2
+    if best is None:
+        raise ValueError("sprites do not fit into %dx%d" % (MAX_SIZE, MAX_SIZE))
+    return best
+
+
+def verify(width, height, placed):
+    rects = [(x - PADDING, y - PADDING, x + w + PADDING, y + h + PADDING, name) for name, x, y, w, h in placed]
+    for i, a in enumerate(rects):
+        if a[0] < 0 or a[1] < 0 or a[2] > width or a[3] > height:
+            raise AssertionError("%s is outside of the atlas" % a[4])
+        for b in rects[i + 1:]:
+            if a[0] < b[2] and b[0] < a[2] and a[1] < b[3] and b[1] < a[3]:
+                raise AssertionError("%s overlaps %s" % (a[4], b[4]))
+
+
+def blit(atlas, width, pixels, x, y, w, h):
+    for row in range(-PADDING, h + PADDING):
+        src = pixels[min(max(row, 0), h - 1)]
+        dst = atlas[y + row]
+        for col in range(-PADDING, w + PADDING):
+            sx = min(max(col, 0), w - 1) * 4
+            dx = (x + col) * 4
+            dst[dx:dx + 4] = src[sx:sx + 4]
+
+
+def main():
+    if len(sys.argv) < 4:
+        print("usage: %s <output.tga> <output.h> <sprite.png>..." % sys.argv[0])
+        return 1
+
+    sprites = []
+    for path in sys.argv[3:]:
+        w, h, pixels = read_png(path)
+        sprites.append((os.path.basename(path), w, h, pixels))
+
+    width, height, placed = pack(sprites)
+    verify(width, height, placed)
+
+    lookup = {s[0]: s[3] for s in sprites}
+    atlas = [bytearray(width * 4) for _ in range(height)]
+    for name, x, y, w, h in placed:
+        blit(atlas, width, lookup[name], x, y, w, h)
+    write_tga(sys.argv[1], width, height, atlas)
+
+    with open(sys.argv[2], "w") as f:
+        f.write("/****************************************************************************\n")
+        f.write(" * UI atlas layout.\n")
+        f.write(" * This file is generated automatically by tools/atlaspack.py.\n")
+        f.write(" ****************************************************************************/\n")
+        f.write("#ifndef _UIATLAS_LAYOUT_H_\n#define _UIATLAS_LAYOUT_H_\n\n")
+        f.write("#define UIATLAS_WIDTH  %d\n#define UIATLAS_HEIGHT %d\n\n" % (width, height))
+        f.write("static const UiAtlasSprite UiAtlasSprites[] = {\n")
+        for name, x, y, w, h in sorted(placed, key=lambda p: p[0].lower()):
+            f.write("\t{\"%s\", %d, %d, %d, %d},\n" % (name, x, y, w, h))
+        f.write("\t{nullptr, 0, 0, 0, 0}\n};\n\n#endif\n")
+
+    print("ui atlas: %d sprites in %dx%d" % (len(placed), width, height))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,160 @@
+/****************************************************************************
+ * Host check of FSStatCache against a fixture tree on the local disk.
+ *
+ * Builds a small tree in a temporary folder and runs the FSUtils queries
+ * through the POSIX backend. Checks that hits, misses and negative entries
+ * are counted as expected, that CreateSubfolder and writes through CFile
+ * make the cached state current again, that the LRU keeps its capacity and
+ * that a stat which races with an invalidation, or a check which runs
+ * between the invalidation and the mkdir of CreateSubfolder, does not leave
+ * a stale entry behind. Four threads query the tree meanwhile at the end.
+ *
+ *   g++ -std=c++17 -O2 -Isrc -Itools/host tools/fs_stat_cache_check.cpp src/fs/CFile.cpp src/fs/FSStatCache.cpp \
+ *       src/fs/FSUtils.cpp src/fs/IFileSystem.cpp src/fs/PosixFileSystem.cpp src/utils/StringTools.cpp -o fs_stat_cache_check -lpthread
+ *   ./fs_stat_cache_check
+ ****************************************************************************/
+#include "fs/FSStatCache.h"
+#include "fs/FSUtils.h"
+#include "fs/PosixFileSystem.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+static uint32_t failures = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            failures++;                                                     \
+        }                                                                   \
+    } while (0)
+
+static std::string root;
+
+//! Runs a query of the same path in the window a concurrent one would hit
+class RacingFileSystem : public PosixFileSystem {
+public:
+    //! created while this stat() runs, as by a write on another thread
+    std::string createOnStat;
+    //! checked right before the folder is created, as by a check on another thread
+    bool checkOnMkdir = false;
+
+    int32_t stat(const char *path, struct stat *st) override {
+        int32_t res = PosixFileSystem::stat(path, st);
+        if (!createOnStat.empty() && createOnStat == path) {
+            createOnStat.clear();
+            FSUtils::saveBufferToFile(path, (void *) "new", 3);
+        }
+        return res;
+    }
+
+    int32_t mkdir(const char *path, mode_t mode) override {
+        if (checkOnMkdir) {
+            checkOnMkdir = false;
+            FSUtils::CheckFile(path);
+        }
+        return PosixFileSystem::mkdir(path, mode);
+    }
+};
+
+static FSStatCacheStats StatsSince(const FSStatCacheStats &before) {
+    FSStatCacheStats now = FSStatCache::GetStats();
+    return {now.hits - before.hits, now.negativeHits - before.negativeHits, now.misses - before.misses,
+            now.evictions - before.evictions, now.invalidations - before.invalidations};
+}
+
+static void CheckQueries() {
+    FSStatCacheStats before = FSStatCache::GetStats();
+    CHECK(FSUtils::CheckFile((root + "/meta/iconTex.tga").c_str()) == 1);
+    CHECK(FSUtils::CheckFile((root + "/meta/iconTex.tga").c_str()) == 1);
+    CHECK(FSUtils::CheckFile((root + "/meta/missing.xml").c_str()) == 0);
+    CHECK(FSUtils::CheckFile((root + "/meta/missing.xml").c_str()) == 0);
+    FSStatCacheStats diff = StatsSince(before);
+    CHECK(diff.misses == 2 && diff.hits == 1 && diff.negativeHits == 1);
+
+    FSStatEntry entry;
+    CHECK(FSStatCache::Stat(root + "/meta/iconTex.tga", &entry) && !entry.isDir && entry.size == 4);
+    CHECK(FSStatCache::Stat(root + "/meta", &entry) && entry.isDir);
+}
+
+static void CheckWrites() {
+    std::string file = root + "/meta/missing.xml";
+    CHECK(FSUtils::CheckFile(file.c_str()) == 0);
+    CHECK(FSUtils::saveBufferToFile(file.c_str(), (void *) "abcdef", 6) == 6);
+    FSStatEntry entry;
+    CHECK(FSStatCache::Stat(file, &entry) && entry.size == 6);
+
+    std::string folder = root + "/save/user/0";
+    CHECK(FSUtils::CheckFile(folder.c_str()) == 0);
+    CHECK(FSUtils::CreateSubfolder((folder + "/").c_str()) == 1);
+    CHECK(FSUtils::CheckFile(folder.c_str()) == 1);
+    CHECK(FSUtils::CheckFile((root + "/save").c_str()) == 1);
+}
+
+static void CheckRaces() {
+    RacingFileSystem racing;
+    IFileSystem::set(&racing);
+
+    std::string file    = root + "/meta/raced.xml";
+    racing.createOnStat = file;
+    CHECK(FSUtils::CheckFile(file.c_str()) == 0);
+    CHECK(FSUtils::CheckFile(file.c_str()) == 1);
+
+    std::string folder  = root + "/raced";
+    racing.checkOnMkdir = true;
+    CHECK(FSUtils::CreateSubfolder(folder.c_str()) == 1);
+    CHECK(!racing.checkOnMkdir);
+    CHECK(FSUtils::CheckFile(folder.c_str()) == 1);
+
+    IFileSystem::set(nullptr);
+}
+
+static void CheckCapacity() {
+    FSStatCache::SetCapacity(8);
+    FSStatCacheStats before = FSStatCache::GetStats();
+    for (int32_t i = 0; i < 16; i++) {
+        FSUtils::CheckFile((root + "/meta/x" + std::to_string(i)).c_str());
+    }
+    CHECK(StatsSince(before).evictions >= 8);
+
+    std::vector<std::thread> threads;
+    for (int32_t t = 0; t < 4; t++) {
+        threads.emplace_back([] {
+            for (int32_t i = 0; i < 20000; i++) {
+                FSUtils::CheckFile((root + "/meta/x" + std::to_string(i % 12)).c_str());
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    FSStatCache::SetCapacity(FSStatCache::DEFAULT_CAPACITY);
+}
+
+int main() {
+    char folder[] = "/tmp/fs_stat_cache_XXXXXX";
+    if (!mkdtemp(folder)) {
+        printf("Failed to create the fixture folder\n");
+        return 1;
+    }
+    root = folder;
+    FSUtils::CreateSubfolder((root + "/meta").c_str());
+    FSUtils::saveBufferToFile((root + "/meta/iconTex.tga").c_str(), (void *) "tga!", 4);
+
+    CheckQueries();
+    CheckWrites();
+    CheckRaces();
+    CheckCapacity();
+
+    system(("rm -rf " + root).c_str());
+
+    if (failures > 0) {
+        printf("%u checks failed\n", failures);
+        return 1;
+    }
+    printf("all checks passed\n");
+    return 0;
+}
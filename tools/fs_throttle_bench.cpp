@@ -0,0 +1,88 @@
+/****************************************************************************
+ * Host benchmark of the file load paths against a simulated device.
+ *
+ * Builds 40 title folders (64 KiB iconTex.tga and a meta.xml each) in a
+ * MemoryFileSystem and puts a ThrottledFileSystem with the NAND, USB HDD and
+ * SD profiles in front of it. For every profile it measures loading all
+ * icons with FSUtils::LoadFileToMem and scanning the title folders with
+ * DirList, serially and with ParallelScan. The delays are injected sleeps,
+ * so the numbers repeat on any machine.
+ *
+ *   g++ -std=c++17 -O2 -Isrc -Itools/host tools/fs_throttle_bench.cpp src/fs/CFile.cpp src/fs/DirList.cpp \
+ *       src/fs/FSStatCache.cpp src/fs/FSUtils.cpp src/fs/IFileSystem.cpp src/fs/MemoryFileSystem.cpp \
+ *       src/fs/PosixFileSystem.cpp src/fs/ThrottledFileSystem.cpp src/utils/StringTools.cpp -o fs_bench -lpthread
+ *   ./fs_bench
+ ****************************************************************************/
+#include "fs/DirList.h"
+#include "fs/FSUtils.h"
+#include "fs/MemoryFileSystem.h"
+#include "fs/ThrottledFileSystem.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+static const uint32_t TITLES    = 40;
+static const char *TITLE_FOLDER = "fs:/vol/storage_mlc01/usr/title/00050000";
+
+static std::string TitleFile(uint32_t title, const char *name) {
+    char path[128];
+    snprintf(path, sizeof(path), "%s/%08X/meta/%s", TITLE_FOLDER, title, name);
+    return path;
+}
+
+static double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static std::vector<std::string> Scan(uint32_t flags, double *ms) {
+    auto start = std::chrono::steady_clock::now();
+    DirList list(TITLE_FOLDER, nullptr, flags);
+    *ms = MillisecondsSince(start);
+
+    std::vector<std::string> paths;
+    for (int32_t i = 0; i < list.GetFilecount(); i++) {
+        paths.emplace_back(list.GetFilepath(i));
+    }
+    return paths;
+}
+
+int main() {
+    MemoryFileSystem memory;
+    std::vector<uint8_t> icon(65580, 0x7F);
+    std::vector<uint8_t> meta(2000, 'x');
+    for (uint32_t title = 0; title < TITLES; title++) {
+        memory.addFile(TitleFile(title, "iconTex.tga"), icon.data(), icon.size());
+        memory.addFile(TitleFile(title, "meta.xml"), meta.data(), meta.size());
+    }
+
+    const ThrottledFileSystem::Profile *profiles[] = {&ThrottledFileSystem::NAND, &ThrottledFileSystem::USB_HDD, &ThrottledFileSystem::SD};
+    const uint32_t scanFlags                       = DirList::Files | DirList::Dirs | DirList::CheckSubfolders;
+
+    printf("%-8s %14s %14s %14s %10s\n", "profile", "load icons", "scan serial", "scan parallel", "same list");
+    for (auto profile : profiles) {
+        ThrottledFileSystem throttled(&memory, *profile);
+        IFileSystem::set(&throttled);
+
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t title = 0; title < TITLES; title++) {
+            uint8_t *buffer = nullptr;
+            uint32_t size   = 0;
+            if (FSUtils::LoadFileToMem(TitleFile(title, "iconTex.tga").c_str(), &buffer, &size) != (int32_t) icon.size()) {
+                printf("failed to load the icon of title %u\n", title);
+                return 1;
+            }
+            free(buffer);
+        }
+        double icons = MillisecondsSince(start);
+
+        double serial, parallel;
+        std::vector<std::string> serialList   = Scan(scanFlags, &serial);
+        std::vector<std::string> parallelList = Scan(scanFlags | DirList::ParallelScan, &parallel);
+
+        printf("%-8s %12.1fms %12.1fms %12.1fms %10s\n", profile->name, icons, serial, parallel, (serialList == parallelList) ? "yes" : "no");
+        IFileSystem::set(nullptr);
+    }
+    return 0;
+}
@@ -0,0 +1,127 @@
+/****************************************************************************
+ * Host check of GlyphCacheWarmer with a font that records the glyphs.
+ *
+ * Checks that UTF-8 names are decoded (é, ™, CJK), that the queue keeps its
+ * order and skips duplicates, that process() caches at most its budget of
+ * characters at both sizes, that no more characters are queued than fit the
+ * MEMORY_GLYPH budget, that the cached bytes are counted and given back when
+ * the font goes away, and that a new font gets the warmed characters again.
+ *
+ *   g++ -std=c++17 -O2 -Isrc -Itools/host tools/glyph_warm_check.cpp src/gui/GlyphCacheWarmer.cpp -o glyph_warm_check
+ *   ./glyph_warm_check
+ ****************************************************************************/
+#include "gui/GlyphCacheWarmer.h"
+#include "utils/MemoryAccounting.h"
+#include <gui/FreeTypeGX.h>
+#include <stdio.h>
+#include <string>
+
+static uint32_t failures = 0;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            failures++;                                                     \
+        }                                                                   \
+    } while (0)
+
+static uint32_t glyphLive   = 0;
+static uint32_t glyphBudget = 0;
+
+void MemoryAccounting::Add(MemoryCategory category, uint32_t bytes) {
+    if (category == MEMORY_GLYPH)
+        glyphLive += bytes;
+}
+
+void MemoryAccounting::Remove(MemoryCategory category, uint32_t bytes) {
+    if (category == MEMORY_GLYPH)
+        glyphLive -= bytes;
+}
+
+uint32_t MemoryAccounting::GetBudget(MemoryCategory category) {
+    return (category == MEMORY_GLYPH) ? glyphBudget : 0;
+}
+
+//! processes until the queue is empty, returns the number of frames it took
+static uint32_t Drain(FreeTypeGX &font, uint32_t perFrame) {
+    uint32_t frames = 0;
+    size_t before;
+    do {
+        before = font.cached.size();
+        GlyphCacheWarmer::process(perFrame);
+        CHECK(font.cached.size() - before <= perFrame * 2);
+        frames++;
+    } while (font.cached.size() != before);
+    return frames - 1;
+}
+
+static void CheckDecodeAndOrder() {
+    glyphBudget = 0;
+    FreeTypeGX font;
+    GlyphCacheWarmer::setFont(&font);
+    GlyphCacheWarmer::push("Pok\xC3\xA9mon\xE2\x84\xA2");
+    GlyphCacheWarmer::push("Poke \xE3\x82\xBC\xE3\x83\xAB\xE3\x83\x80");
+    //! a cut sequence is skipped
+    GlyphCacheWarmer::push("\xE3\x82");
+
+    const wchar_t expected[] = L"Pokémn™e ゼルダ";
+    uint32_t frames          = Drain(font, 3);
+    size_t count             = wcslen(expected);
+    CHECK(frames == (count + 2) / 3);
+    CHECK(font.cached.size() == count * 2);
+    for (size_t i = 0; i < count && i * 2 + 1 < font.cached.size(); i++) {
+        CHECK(font.cached[i * 2].first == expected[i] && font.cached[i * 2].second == 52);
+        CHECK(font.cached[i * 2 + 1].first == expected[i] && font.cached[i * 2 + 1].second == 104);
+    }
+    CHECK(glyphLive == count * GlyphCacheWarmer::getGlyphSize());
+
+    //! glyphs already warmed are not queued again
+    GlyphCacheWarmer::push("Pokemon");
+    CHECK(Drain(font, 8) == 0);
+
+    GlyphCacheWarmer::setFont(nullptr);
+    CHECK(glyphLive == 0);
+}
+
+static void CheckBudget() {
+    //! room for 100 glyphs, a large CJK library pushes thousands of characters
+    glyphBudget = 100 * GlyphCacheWarmer::getGlyphSize();
+    FreeTypeGX font;
+    GlyphCacheWarmer::setFont(&font);
+
+    std::string names;
+    for (uint32_t c = 0x4E00; c < 0x4E00 + 3000; c++) {
+        names += (char) (0xE0 | (c >> 12));
+        names += (char) (0x80 | ((c >> 6) & 0x3F));
+        names += (char) (0x80 | (c & 0x3F));
+    }
+    GlyphCacheWarmer::push(names);
+    Drain(font, 8);
+    CHECK(font.cached.size() <= 100 * 2);
+    CHECK(glyphLive <= glyphBudget);
+
+    //! a new font gets the warmed characters again, the old ones are not counted anymore
+    FreeTypeGX other;
+    size_t warmed = font.cached.size() / 2;
+    GlyphCacheWarmer::setFont(&other);
+    CHECK(glyphLive == 0);
+    Drain(other, 8);
+    CHECK(other.cached.size() == warmed * 2);
+    CHECK(glyphLive == warmed * GlyphCacheWarmer::getGlyphSize());
+
+    GlyphCacheWarmer::setFont(nullptr);
+    CHECK(glyphLive == 0);
+}
+
+int main() {
+    CheckDecodeAndOrder();
+    CheckBudget();
+
+    if (failures > 0) {
+        printf("%u checks failed\n", failures);
+        return 1;
+    }
+    printf("all checks passed\n");
+    return 0;
+}
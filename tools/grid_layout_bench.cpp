@@ -0,0 +1,431 @@
+/****************************************************************************
+ * Host micro benchmark of the icon grid layout.
+ *
+ * Compares the per frame cost of the former full rebuild of GuiIconGrid
+ * (copy all containers, remove every button, append the visible ones) with
+ * the dirty slot tracking of GridLayout, while scrolling and while an icon
+ * is held. A vector of pointers stands in for the GuiFrame element list.
+ *
+ * The second table compares the icon widgets created per title in both grids
+ * with the fixed widget pools. Creating a widget is approximated by the vertex
+ * buffers GameIcon allocates and fills.
+ *
+ * The third table is the input update of one controller. Walking the children
+ * (every title button as initially appended, or the shown widgets of the pool)
+ * is compared with looking up the slot under the pointer with GridLayout. A
+ * child update is approximated by the state, bounds and trigger tests
+ * GuiButton::update does.
+ *
+ * The fourth table is dragging an icon across the page and dropping it every
+ * second. The former drag relaid the whole grid every frame and found the drop
+ * target by copying the containers and scanning the positions. Now a frame
+ * moves the held icon and looks up the cell under it, a drop swaps two slots
+ * and rebinds their widgets.
+ *
+ *   g++ -std=c++17 -O2 -Isrc tools/grid_layout_bench.cpp src/gui/GridLayout.cpp -o grid_bench
+ *   ./grid_bench
+ ****************************************************************************/
+#include "gui/GridLayout.h"
+#include <stdint.h>
+
+//! needs stdint.h
+#include "gui/GameIconModel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <malloc.h>
+#include <map>
+#include <stdio.h>
+#include <string.h>
+#include <unordered_map>
+#include <vector>
+
+static const uint32_t COLS       = 5;
+static const uint32_t ROWS       = 3;
+static const uint32_t PER_PAGE   = COLS * ROWS;
+static const int32_t PAGE_WIDTH  = 1280;
+static const int32_t SCROLL_STEP = 35;
+
+struct Button {
+    float x = 0.0f;
+    float y = 0.0f;
+    bool holdable = true;
+};
+
+//! like GuiFrame, remove() searches the element list
+struct Frame {
+    std::vector<Button *> elements;
+
+    void remove(Button *b) {
+        auto itr = std::find(elements.begin(), elements.end(), b);
+        if (itr != elements.end())
+            elements.erase(itr);
+    }
+
+    void append(Button *b) {
+        remove(b);
+        elements.push_back(b);
+    }
+};
+
+struct Grid {
+    std::map<uint64_t, Button *> containers;
+    std::vector<Button> storage;
+    std::vector<Button> empty;
+    std::vector<uint64_t> position;
+    Frame frame;
+
+    explicit Grid(uint32_t titles) : storage(titles), empty(PER_PAGE * 2) {
+        for (uint32_t i = 0; i < titles; i++) {
+            containers[i + 1] = &storage[i];
+            position.push_back(i + 1);
+        }
+    }
+
+    //! the layout GuiIconGrid did whenever something changed
+    void fullRebuild(int32_t currentLeft, int32_t targetLeft) {
+        std::vector<std::pair<uint64_t, Button *>> vec(containers.begin(), containers.end());
+        for (auto const &x : vec) {
+            frame.remove(x.second);
+        }
+        for (auto &x : empty) {
+            frame.remove(&x);
+        }
+
+        uint32_t pages     = (position.size() + PER_PAGE - 1) / PER_PAGE;
+        uint32_t startPage = -(currentLeft / PAGE_WIDTH);
+        uint32_t endPage   = startPage;
+        if (targetLeft != currentLeft) {
+            for (auto const &x : vec) {
+                x.second->holdable = false;
+            }
+            endPage = std::min(endPage + 1, pages);
+        } else {
+            for (auto const &x : vec) {
+                x.second->holdable = true;
+            }
+        }
+
+        uint32_t emptyUse = 0;
+        for (uint32_t i = startPage * PER_PAGE; i < (endPage + 1) * PER_PAGE; i++) {
+            Button *element = nullptr;
+            if (i < position.size() && position[i] != 0) {
+                auto itr = containers.find(position[i]);
+                if (itr != containers.end())
+                    element = itr->second;
+            }
+            if (element == nullptr) {
+                if (emptyUse >= empty.size())
+                    break;
+                element = &empty[emptyUse++];
+            }
+            element->x = currentLeft + (i / PER_PAGE) * PAGE_WIDTH + (i % COLS) * 192.0f;
+            element->y = ((i / COLS) % ROWS) * 192.0f;
+            frame.append(element);
+        }
+    }
+};
+
+struct IncrementalGrid {
+    std::map<uint64_t, Button *> containers;
+    std::vector<Button> storage;
+    std::vector<Button *> freeEmpty;
+    std::vector<Button> empty;
+    std::vector<Button *> slotButtons;
+    std::vector<uint32_t> dirty;
+    //! the title ids kept by IconGridModel
+    std::vector<uint64_t> slots;
+    GridLayout layout;
+    Frame frame;
+    float frameX = 0.0f;
+
+    explicit IncrementalGrid(uint32_t titles) : storage(titles), empty(PER_PAGE * 2), layout(COLS, ROWS) {
+        for (auto &e : empty) {
+            freeEmpty.push_back(&e);
+        }
+        layout.setGeometry(192.0f, 192.0f, PAGE_WIDTH, 30.0f);
+        for (uint32_t i = 0; i < titles; i++) {
+            containers[i + 1] = &storage[i];
+            slots.push_back(i + 1);
+        }
+    }
+
+    //! what GuiIconGrid::process() does per frame
+    void frameUpdate(int32_t currentLeft, int32_t targetLeft) {
+        frameX             = currentLeft;
+        uint32_t pages     = (slots.size() + PER_PAGE - 1) / PER_PAGE;
+        uint32_t startPage = -(currentLeft / PAGE_WIDTH);
+        uint32_t endPage   = startPage;
+        if (targetLeft != currentLeft)
+            endPage = std::min(endPage + 1, pages);
+        layout.setVisiblePages(startPage, endPage);
+
+        layout.takeDirty(dirty);
+        for (uint32_t slot : dirty) {
+            if (slot >= slotButtons.size())
+                slotButtons.resize(slot + 1, nullptr);
+            if (slotButtons[slot]) {
+                frame.remove(slotButtons[slot]);
+                if (slotButtons[slot] >= &empty.front() && slotButtons[slot] <= &empty.back())
+                    freeEmpty.push_back(slotButtons[slot]);
+                slotButtons[slot] = nullptr;
+            }
+        }
+        for (uint32_t slot : dirty) {
+            if (!layout.isVisible(slot))
+                continue;
+            Button *element = nullptr;
+            auto itr        = containers.find((slot < slots.size()) ? slots[slot] : 0);
+            if (itr != containers.end()) {
+                element = itr->second;
+            } else if (!freeEmpty.empty()) {
+                element = freeEmpty.back();
+                freeEmpty.pop_back();
+            } else {
+                continue;
+            }
+            layout.getSlotPosition(slot, &element->x, &element->y);
+            frame.append(element);
+            slotButtons[slot] = element;
+        }
+    }
+};
+
+static const uint32_t GRIDS = 2;
+//! shown pages while scrolling, one page ahead and the dragged icon
+static const uint32_t POOL_WIDGETS = PER_PAGE * 3 + 1;
+
+//! the vertex buffers GameIcon allocates and fills in its constructor
+struct IconBuffers {
+    static const int32_t COUNT = 6;
+    void *buffers[COUNT];
+
+    IconBuffers() {
+        const size_t sizes[COUNT]   = {sizeof(cfGameIconPosVtxs), sizeof(cfGameIconTexCoords), sizeof(cfGameIconTexCoords),
+                                       sizeof(cfGameIconStrokeVtxs), cuGameIconStrokeVtxCount * 2 * sizeof(float), cuGameIconStrokeVtxCount * 4};
+        const void *sources[COUNT] = {cfGameIconPosVtxs, cfGameIconTexCoords, cfGameIconTexCoords, cfGameIconStrokeVtxs, nullptr, nullptr};
+        for (int32_t i = 0; i < COUNT; i++) {
+            buffers[i] = memalign(0x40, sizes[i]);
+            if (sources[i])
+                memcpy(buffers[i], sources[i], sizes[i]);
+            else
+                memset(buffers[i], 0xff, sizes[i]);
+        }
+    }
+
+    ~IconBuffers() {
+        for (auto buffer : buffers) {
+            free(buffer);
+        }
+    }
+
+    static size_t Bytes() {
+        return sizeof(cfGameIconPosVtxs) + 2 * sizeof(cfGameIconTexCoords) + sizeof(cfGameIconStrokeVtxs) + cuGameIconStrokeVtxCount * (2 * sizeof(float) + 4);
+    }
+};
+
+//! the tests GuiButton::update does for each child, whether it is hit or not
+struct InputChild {
+    float left, right, bottom, top;
+    uint32_t chan[2];
+    uint32_t buttons[2];
+    uint32_t state = 0;
+
+    void update(float x, float y, uint32_t chanMask, uint32_t pressed) {
+        if (state & 0x80000000)
+            return;
+        bool inside = x > left && x < right && y > bottom && y < top;
+        if (inside)
+            state |= 1;
+        else if (state & 1)
+            state &= ~1u;
+        for (int32_t i = 0; i < 2; i++) {
+            if ((chan[i] & chanMask) && (buttons[i] & pressed) && inside)
+                state |= 2;
+        }
+    }
+};
+
+static volatile uint32_t inputSink;
+
+static double MeasureInput(uint32_t children, bool hitTest, uint32_t frames) {
+    GridLayout hitLayout(COLS, ROWS);
+    hitLayout.setGeometry(192.0f, 192.0f, PAGE_WIDTH, 30.0f);
+    std::vector<InputChild> elements(children);
+    for (uint32_t i = 0; i < children; i++) {
+        float x, y;
+        hitLayout.getSlotPosition(i, &x, &y);
+        elements[i] = {x - 64.0f, x + 64.0f, y - 64.0f, y + 64.0f, {1, 0x1e}, {0x8000, 0x800}};
+    }
+    //! the other children of the grid: direction buttons, arrows, drag listener
+    std::vector<InputChild> others(9, InputChild{-640.0f, 640.0f, -360.0f, 360.0f, {0x1f, 0x1f}, {0x4, 0x8}});
+
+    uint32_t sink = 0;
+    auto start    = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < frames; i++) {
+        float x = (float) (i * 37 % 1200) - 600.0f;
+        float y = (float) (i * 23 % 600) - 300.0f;
+        for (auto &other : others) {
+            other.update(x, y, 1, 0x8000);
+        }
+        if (hitTest) {
+            int32_t slot = hitLayout.getSlotAt(x, y);
+            if (slot >= 0 && (uint32_t) slot < children)
+                elements[slot].update(x, y, 1, 0x8000);
+        } else {
+            for (auto &element : elements) {
+                element.update(x, y, 1, 0x8000);
+            }
+        }
+        sink += elements[i % children].state;
+    }
+    inputSink = sink;
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / frames;
+}
+
+static const uint32_t DROP_FRAMES = 60;
+
+//! the held button position for frame i, it wanders over the cells of page 0
+static void DragPosition(uint32_t i, float *x, float *y) {
+    *x = (float) (i * 13 % 960) - 480.0f;
+    *y = (float) (i * 7 % 480) - 240.0f;
+}
+
+static double MeasureOldDrag(uint32_t titles, uint32_t frames) {
+    Grid grid(titles);
+    Button *held = grid.containers.begin()->second;
+    uint64_t sink = 0;
+    auto start    = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < frames; i++) {
+        DragPosition(i, &held->x, &held->y);
+        //! bUpdatePositions was forced while an icon was held
+        grid.fullRebuild(0, 0);
+        if (i % DROP_FRAMES == DROP_FRAMES - 1) {
+            //! the target button is given, its title id is found through the containers
+            Button *target = grid.frame.elements[(i / DROP_FRAMES) % grid.frame.elements.size()];
+            std::vector<std::pair<uint64_t, Button *>> vec(grid.containers.begin(), grid.containers.end());
+            uint64_t targetId = 0;
+            for (auto const &x : vec) {
+                if (x.second == target)
+                    targetId = x.first;
+            }
+            auto from = std::find(grid.position.begin(), grid.position.end(), grid.containers.begin()->first);
+            auto to   = std::find(grid.position.begin(), grid.position.end(), targetId);
+            if (from != grid.position.end() && to != grid.position.end())
+                std::swap(*from, *to);
+            sink += targetId;
+        }
+    }
+    inputSink = (uint32_t) sink;
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / frames;
+}
+
+static double MeasureNewDrag(uint32_t titles, uint32_t frames) {
+    IncrementalGrid inc(titles);
+    inc.frameUpdate(0, 0);
+    std::unordered_map<uint64_t, uint32_t> slotOfId;
+    std::unordered_map<Button *, uint32_t> widgetOfButtons;
+    for (uint32_t i = 0; i < titles; i++) {
+        slotOfId[i + 1]                  = i;
+        widgetOfButtons[&inc.storage[i]] = i;
+    }
+    Button held;
+    widgetOfButtons[&held] = titles;
+    uint64_t heldId        = 1;
+    uint32_t heldSlot      = 0;
+    int32_t target         = -1;
+    uint64_t sink          = 0;
+    auto start             = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < frames; i++) {
+        DragPosition(i, &held.x, &held.y);
+        sink += widgetOfButtons.find(&held)->second;
+        int32_t slot = inc.layout.getSlotAt(held.x, held.y);
+        if (slot != target) {
+            //! the old and new target change their highlight
+            target = slot;
+        }
+        if (i % DROP_FRAMES == DROP_FRAMES - 1 && target >= 0 && (uint32_t) target < inc.slots.size()) {
+            uint64_t targetId = inc.slots[target];
+            std::swap(inc.slots[heldSlot], inc.slots[target]);
+            slotOfId[heldId] = target;
+            if (targetId)
+                slotOfId[targetId] = heldSlot;
+            inc.layout.markDirty(heldSlot);
+            inc.layout.markDirty(target);
+            heldId   = inc.slots[(i / DROP_FRAMES) % PER_PAGE];
+            heldSlot = slotOfId[heldId];
+        }
+        inc.frameUpdate(0, 0);
+    }
+    inputSink = (uint32_t) sink;
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / frames;
+}
+
+static double CreateWidgets(uint32_t count) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<IconBuffers> widgets(count);
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+template<typename F>
+static double MeasureFrames(F frame, uint32_t frames) {
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < frames; i++) {
+        frame(i);
+    }
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / frames;
+}
+
+int main() {
+    printf("%8s %22s %22s %22s %22s\n", "titles", "rebuild scroll us", "dirty scroll us", "rebuild held us", "dirty held us");
+    for (uint32_t titles : {30u, 300u, 1000u, 5000u}) {
+        //! one page turn is 1280 / 35 frames, scroll back and forth between page 0 and 1
+        const uint32_t frames = 2000;
+        auto scrollOffset     = [](uint32_t i) {
+            int32_t step = i % 74;
+            return (step < 37) ? -std::min(step * SCROLL_STEP, PAGE_WIDTH) : -std::max(PAGE_WIDTH - (step - 37) * SCROLL_STEP, 0);
+        };
+
+        Grid grid(titles);
+        double rebuildScroll = MeasureFrames([&](uint32_t i) {
+            int32_t cur = scrollOffset(i);
+            grid.fullRebuild(cur, (i % 74) < 37 ? -PAGE_WIDTH : 0);
+        },
+                                             frames);
+        double rebuildHeld = MeasureFrames([&](uint32_t) { grid.fullRebuild(0, 0); }, frames);
+
+        IncrementalGrid inc(titles);
+        double dirtyScroll = MeasureFrames([&](uint32_t i) {
+            int32_t cur = scrollOffset(i);
+            inc.frameUpdate(cur, (i % 74) < 37 ? -PAGE_WIDTH : 0);
+        },
+                                           frames);
+        inc.frameUpdate(0, 0);
+        double dirtyHeld = MeasureFrames([&](uint32_t) { inc.frameUpdate(0, 0); }, frames);
+
+        printf("%8u %22.2f %22.2f %22.2f %22.2f\n", titles, rebuildScroll, dirtyScroll, rebuildHeld, dirtyHeld);
+    }
+
+    printf("\n%8s %16s %18s %16s %16s %18s %16s\n", "titles", "per title icons", "per title KiB", "per title ms", "pooled icons", "pooled KiB", "pooled ms");
+    for (uint32_t titles : {100u, 1000u, 5000u}) {
+        uint32_t perTitle = titles * GRIDS;
+        uint32_t pooled   = POOL_WIDGETS * GRIDS;
+        printf("%8u %16u %18zu %16.2f %16u %18zu %16.2f\n", titles,
+               perTitle, perTitle * IconBuffers::Bytes() / 1024, CreateWidgets(perTitle),
+               pooled, pooled * IconBuffers::Bytes() / 1024, CreateWidgets(pooled));
+    }
+
+    printf("\n%8s %22s %22s %22s\n", "titles", "all buttons us", "pooled walk us", "hit test us");
+    for (uint32_t titles : {100u, 1000u, 5000u}) {
+        const uint32_t frames = 20000;
+        printf("%8u %22.3f %22.3f %22.3f\n", titles,
+               MeasureInput(titles + PER_PAGE * 2, false, frames), MeasureInput(PER_PAGE * 2, false, frames), MeasureInput(PER_PAGE * 2, true, frames));
+    }
+
+    printf("\n%8s %22s %22s\n", "titles", "former drag us", "swap drag us");
+    for (uint32_t titles : {100u, 1000u, 5000u}) {
+        const uint32_t frames = 6000;
+        printf("%8u %22.3f %22.3f\n", titles, MeasureOldDrag(titles, frames), MeasureNewDrag(titles, frames));
+    }
+    return 0;
+}
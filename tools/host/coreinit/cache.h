@@ -0,0 +1,6 @@
+//! Host stand-in for the wut header, only for the benchmarks in tools/
+#pragma once
+
+#include <stdint.h>
+
+static inline void DCFlushRange(void *addr, uint32_t size) {}
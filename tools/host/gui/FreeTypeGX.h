@@ -0,0 +1,17 @@
+//! Host stand-in for the libgui font, only for the checks in tools/
+#pragma once
+
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+//! Records the glyphs it is asked for instead of rasterizing them
+class FreeTypeGX {
+public:
+    uint16_t getCharWidth(const wchar_t wChar, int16_t pixelSize, const wchar_t prevChar = 0x0000) {
+        cached.emplace_back(wChar, pixelSize);
+        return pixelSize / 2;
+    }
+
+    std::vector<std::pair<wchar_t, int16_t>> cached;
+};
@@ -0,0 +1,9 @@
+//! Host stand-in for the libgui decoder, only for the benchmarks in tools/
+#pragma once
+
+#include "SoundDecoder.hpp"
+
+class OggDecoder : public SoundDecoder {
+public:
+    OggDecoder(const uint8_t *data, int32_t length) : SoundDecoder(data, length) {}
+};
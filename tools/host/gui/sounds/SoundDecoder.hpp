@@ -0,0 +1,37 @@
+//! Host stand-in for the libgui decoder, only for the benchmarks in tools/.
+//! Every stream decodes to 0.15 s of 48 kHz stereo PCM.
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+class SoundDecoder {
+public:
+    enum SoundFormats {
+        FORMAT_PCM_16_BIT = 0x0A,
+        FORMAT_PCM_8_BIT  = 0x19,
+    };
+    enum SoundChannels {
+        CHANNELS_MONO   = 0x100,
+        CHANNELS_STEREO = 0x200,
+    };
+
+    SoundDecoder(const uint8_t *data, int32_t length) {}
+
+    virtual ~SoundDecoder() {}
+
+    uint16_t GetFormat() {
+        return FORMAT_PCM_16_BIT | CHANNELS_STEREO;
+    }
+
+    uint16_t GetSampleRate() {
+        return 48000;
+    }
+
+    int32_t Read(uint8_t *buffer, int32_t size, int32_t pos) {
+        const int32_t total = 48000 * 4 * 15 / 100;
+        int32_t count       = (total - pos < size) ? total - pos : size;
+        memset(buffer, 0x11, count);
+        return count;
+    }
+};
@@ -0,0 +1,10 @@
+//! Host stand-in for the libgui sound handler, only for the benchmarks in tools/
+#pragma once
+
+class SoundHandler {
+public:
+    static SoundHandler *instance() {
+        static SoundHandler handler;
+        return &handler;
+    }
+};
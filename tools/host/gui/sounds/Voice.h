@@ -0,0 +1,25 @@
+//! Host stand-in for the libgui AX voice, only for the benchmarks in tools/.
+//! Starting a voice hands its buffer to NullSinkPlay(), which the benchmark defines.
+#pragma once
+
+#include <stdint.h>
+
+void NullSinkPlay(const uint8_t *buffer, uint32_t size);
+
+class Voice {
+public:
+    enum VoicePriorities {
+        PRIO_MIN = 1,
+        PRIO_MAX = 31,
+    };
+
+    explicit Voice(int32_t prio) {}
+
+    void play(const uint8_t *buffer, uint32_t bufferSize, const uint8_t *nextBuffer, uint32_t nextBufSize, uint16_t format, uint32_t sampleRate) {
+        NullSinkPlay(buffer, bufferSize);
+    }
+
+    void stop() {}
+
+    void setVolume(uint32_t volume) {}
+};
@@ -0,0 +1,13 @@
+//! Host stand-in for the AsyncExecutor, only for the benchmarks in tools/.
+//! Each task runs on its own detached thread.
+#pragma once
+
+#include <functional>
+#include <thread>
+
+class AsyncExecutor {
+public:
+    static void execute(std::function<void()> func) {
+        std::thread(func).detach();
+    }
+};
@@ -0,0 +1,6 @@
+//! Host stand-in for the wut header, only for the benchmarks in tools/. Logging is dropped.
+#pragma once
+
+static inline void WHBLogPrintf(const char *fmt, ...) {}
+
+static inline void WHBLogWritef(const char *fmt, ...) {}
@@ -0,0 +1,9 @@
+//! Host stand-in for the wut header, only for the benchmarks in tools/
+#pragma once
+
+#include <stdint.h>
+
+typedef int32_t BOOL;
+
+#define TRUE  1
+#define FALSE 0
@@ -0,0 +1,152 @@
+#!/usr/bin/env python3
+#
+# Reader for the I/O traces written by IOTracer (see src/fs/IOTracer.h).
+#
+#   iotrace.py summary iotrace.bin
+#   iotrace.py replay iotrace.bin --root /path/to/nand/dump [--timing]
+#
+# "replay" maps every "<device>:" path onto --root and re-runs the opens, reads,
+# seeks and stats in the recorded order against the host file system.
+
+import argparse
+import os
+import struct
+import sys
+import time
+from collections import OrderedDict
+
+EVENT_NAMES = {1: "open", 2: "read", 3: "write", 4: "seek", 5: "close", 6: "stat", 7: "mkdir", 8: "opendir"}
+NO_PATH = 0xFFFF
+
+
+class Trace:
+    def __init__(self, data):
+        if data[0:4] not in (b"LIOT", b"TOIL"):
+            raise ValueError("not an I/O trace")
+        order = ">" if struct.unpack(">I", data[4:8])[0] == 0x01020304 else "<"
+        version, count, dropped, path_count = struct.unpack(order + "4I", data[8:24])
+        if version != 1:
+            raise ValueError("unsupported trace version %d" % version)
+
+        offset = 24
+        self.paths = []
+        for _ in range(path_count):
+            (length,) = struct.unpack(order + "H", data[offset:offset + 2])
+            offset += 2
+            self.paths.append(data[offset:offset + length].decode("utf-8", "replace"))
+            offset += length
+
+        self.dropped = dropped
+        self.events = []
+        event = struct.Struct(order + "IIiHHB3x")
+        for _ in range(count):
+            self.events.append(event.unpack_from(data, offset))
+            offset += event.size
+
+    def path(self, index):
+        return self.paths[index] if index < len(self.paths) else "<unknown>"
+
+
+def summary(trace):
+    files = OrderedDict()
+    for (stamp, duration, value, path, handle, kind) in trace.events:
+        name = trace.path(path) if path != NO_PATH else "<unknown>"
+        entry = files.setdefault(name, {"open": 0, "read": 0, "bytes": 0, "stat": 0, "miss": 0, "us": 0})
+        entry["us"] += duration
+        if kind == 1:
+            entry["open"] += 1
+            if value < 0:
+                entry["miss"] += 1
+        elif kind == 2:
+            entry["read"] += 1
+            entry["bytes"] += max(value, 0)
+        elif kind == 6:
+            entry["stat"] += 1
+            if value < 0:
+                entry["miss"] += 1
+        elif kind == 8 and value < 0:
+            entry["miss"] += 1
+
+    if trace.events:
+        span = trace.events[-1][0] + trace.events[-1][1] - trace.events[0][0]
+    else:
+        span = 0
+    busy = sum(e["us"] for e in files.values())
+    print("%d events, %d lost to the ring buffer, %d paths, %.1f ms span, %.1f ms in the file system"
+          % (len(trace.events), trace.dropped, len(files), span / 1000.0, busy / 1000.0))
+    print()
+    print("%8s %6s %6s %10s %6s %6s  %s" % ("ms", "opens", "reads", "bytes", "stats", "miss", "path"))
+    for name, e in sorted(files.items(), key=lambda x: -x[1]["us"]):
+        print("%8.1f %6d %6d %10d %6d %6d  %s" % (e["us"] / 1000.0, e["open"], e["read"], e["bytes"], e["stat"], e["miss"], name))
+
+    redundant = [(n, e) for n, e in files.items() if e["open"] - e["miss"] > 1 and e["bytes"] > 0]
+    if redundant:
+        print()
+        print("Files opened and read more than once:")
+        for name, e in sorted(redundant, key=lambda x: -x[1]["bytes"]):
+            print("  %dx  %10d bytes  %s" % (e["open"] - e["miss"], e["bytes"], name))
+
+
+def host_path(root, path):
+    if ":" in path:
+        path = path.split(":", 1)[1]
+    return os.path.join(root, path.lstrip("/"))
+
+
+def replay(trace, root, timing):
+    handles = {}
+    misses = 0
+    start = time.perf_counter()
+    first = trace.events[0][0] if trace.events else 0
+    for (stamp, duration, value, path, handle, kind) in trace.events:
+        if timing:
+            wait = (stamp - first) / 1e6 - (time.perf_counter() - start)
+            if wait > 0:
+                time.sleep(wait)
+        name = host_path(root, trace.path(path)) if path != NO_PATH else None
+        try:
+            if kind == 1 and value >= 0 and name:
+                handles[handle] = os.open(name, os.O_RDONLY)
+            elif kind == 2 and handle in handles:
+                os.read(handles[handle], max(value, 0))
+            elif kind == 4 and handle in handles and value >= 0:
+                os.lseek(handles[handle], value, os.SEEK_SET)
+            elif kind == 5 and handle in handles:
+                os.close(handles.pop(handle))
+            elif kind == 6 and name:
+                os.stat(name)
+            elif kind == 8 and value >= 0 and name:
+                os.listdir(name)
+        except OSError:
+            misses += 1
+    for fd in handles.values():
+        os.close(fd)
+
+    recorded = sum(e[1] for e in trace.events) / 1000.0
+    print("replayed %d events in %.1f ms (%.1f ms in the file system when recorded), %d calls failed on the host"
+          % (len(trace.events), (time.perf_counter() - start) * 1000.0, recorded, misses))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    sub = parser.add_subparsers(dest="command", required=True)
+    p = sub.add_parser("summary")
+    p.add_argument("trace")
+    p = sub.add_parser("replay")
+    p.add_argument("trace")
+    p.add_argument("--root", required=True, help="host folder that stands in for the device root")
+    p.add_argument("--timing", action="store_true", help="keep the recorded gaps between the calls")
+    args = parser.parse_args()
+
+    with open(args.trace, "rb") as f:
+        trace = Trace(f.read())
+
+    if args.command == "summary":
+        summary(trace)
+    else:
+        replay(trace, args.root, args.timing)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
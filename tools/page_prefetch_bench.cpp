@@ -0,0 +1,205 @@
+/****************************************************************************
+ * Host simulation of the icon prefetch.
+ *
+ * Replays a navigation through a large library: bursts of page turns in one
+ * direction, pauses, held page turns while dragging and jumps of the
+ * selection. A loader thread stand-in loads one icon every few milliseconds
+ * from its request list. An icon counts as a hit when it is loaded at the
+ * moment its page becomes the scroll target, as TitlePrefetcher counts it.
+ *
+ *  - list order: the former loading pass, every icon in list order, no budget
+ *  - on demand:  only the target page is requested
+ *  - predicted:  PagePredictor ranks the pages, icons beyond the budget are
+ *                evicted in load order unless requested
+ *
+ *   g++ -std=c++17 -O2 -Isrc tools/page_prefetch_bench.cpp src/gui/PagePredictor.cpp src/gui/Animation.cpp -o prefetch_bench
+ *   ./prefetch_bench
+ ****************************************************************************/
+#include "gui/PagePredictor.h"
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <stdio.h>
+#include <vector>
+
+typedef PagePredictor::Clock Clock;
+
+static const uint32_t PER_PAGE = 15;
+
+enum Mode {
+    LIST_ORDER,
+    ON_DEMAND,
+    PREDICTED
+};
+
+struct Turn {
+    Clock::duration at;
+    uint32_t page;
+    //! -1, 0 or 1
+    int32_t held;
+};
+
+static std::vector<Turn> MakeTrace(uint32_t pages, std::mt19937 &rng) {
+    std::vector<Turn> trace;
+    Clock::duration t = std::chrono::milliseconds(2000);
+    uint32_t page     = 0;
+    while (trace.size() < 400) {
+        uint32_t kind = rng() % 10;
+        if (kind < 6) {
+            //! a burst of arrow clicks in one direction
+            int32_t dir    = (page == 0 || (page + 1 < pages && rng() % 3)) ? 1 : -1;
+            uint32_t count = 1 + rng() % 5;
+            for (uint32_t i = 0; i < count; i++) {
+                if ((dir < 0 && page == 0) || (dir > 0 && page + 1 >= pages))
+                    break;
+                page += dir;
+                t += std::chrono::milliseconds(250 + rng() % 500);
+                trace.push_back({t, page, 0});
+            }
+        } else if (kind < 8) {
+            //! an icon is dragged onto an arrow, the pages turn every 500 ms
+            int32_t dir    = (page + 1 < pages) ? 1 : -1;
+            uint32_t count = 2 + rng() % 4;
+            t += std::chrono::milliseconds(600);
+            trace.push_back({t, page, dir});
+            for (uint32_t i = 0; i < count; i++) {
+                if ((dir < 0 && page == 0) || (dir > 0 && page + 1 >= pages))
+                    break;
+                page += dir;
+                t += std::chrono::milliseconds(500);
+                trace.push_back({t, page, dir});
+            }
+            trace.push_back({t + std::chrono::milliseconds(100), page, 0});
+        } else {
+            //! the selection jumps, e.g. after a search
+            page = rng() % pages;
+            t += std::chrono::milliseconds(300);
+            trace.push_back({t, page, 0});
+        }
+        //! looking at the page
+        t += std::chrono::milliseconds(500 + rng() % 3000);
+    }
+    return trace;
+}
+
+struct Result {
+    uint32_t hits      = 0;
+    uint32_t misses    = 0;
+    uint32_t peakIcons = 0;
+    uint32_t loads     = 0;
+};
+
+static Result Simulate(Mode mode, uint32_t titles, uint32_t budgetIcons, Clock::duration loadTime, const std::vector<Turn> &trace) {
+    uint32_t pages = (titles + PER_PAGE - 1) / PER_PAGE;
+    std::vector<bool> loaded(titles, false);
+    std::deque<uint32_t> loadOrder;
+    uint32_t loadedCount = 0;
+
+    std::vector<uint32_t> requests;
+    uint32_t nextRequest = 0;
+    uint32_t listCursor  = 0;
+
+    PagePredictor predictor;
+    std::vector<uint32_t> predicted;
+    Clock::time_point start = Clock::time_point();
+    Clock::time_point next  = start;
+    Result res;
+
+    auto request = [&](uint32_t target, Clock::time_point now) {
+        requests.clear();
+        nextRequest = 0;
+        if (mode == ON_DEMAND) {
+            predicted.assign(1, target);
+        } else {
+            predictor.predict(pages, now, predicted);
+        }
+        for (uint32_t page : predicted) {
+            for (uint32_t i = page * PER_PAGE; i < std::min((page + 1) * PER_PAGE, titles); i++) {
+                requests.push_back(i);
+            }
+        }
+    };
+
+    //! loads what the loader finished until now
+    auto advance = [&](Clock::time_point now) {
+        while (next + loadTime <= now) {
+            int32_t title = -1;
+            if (mode == LIST_ORDER) {
+                if (listCursor < titles)
+                    title = listCursor++;
+            } else {
+                while (nextRequest < requests.size() && loaded[requests[nextRequest]]) {
+                    nextRequest++;
+                }
+                if (nextRequest < requests.size()) {
+                    title = requests[nextRequest++];
+                } else if (listCursor < titles && loadedCount < budgetIcons) {
+                    //! the loading pass fills the budget in list order
+                    while (listCursor < titles && loaded[listCursor])
+                        listCursor++;
+                    if (listCursor < titles)
+                        title = listCursor++;
+                }
+            }
+            if (title < 0) {
+                next = now;
+                return;
+            }
+            next += loadTime;
+            loaded[title] = true;
+            loadOrder.push_back(title);
+            loadedCount++;
+            res.loads++;
+            if (mode != LIST_ORDER) {
+                for (auto itr = loadOrder.begin(); loadedCount > budgetIcons && itr != loadOrder.end();) {
+                    if (std::find(requests.begin(), requests.end(), *itr) != requests.end()) {
+                        ++itr;
+                        continue;
+                    }
+                    loaded[*itr] = false;
+                    loadedCount--;
+                    itr = loadOrder.erase(itr);
+                }
+            }
+            res.peakIcons = std::max(res.peakIcons, loadedCount);
+        }
+    };
+
+    request(0, start);
+    uint32_t target = 0;
+    for (auto const &turn : trace) {
+        Clock::time_point now = start + turn.at;
+        advance(now);
+        if (turn.page != target) {
+            for (uint32_t i = turn.page * PER_PAGE; i < std::min((turn.page + 1) * PER_PAGE, titles); i++) {
+                if (loaded[i])
+                    res.hits++;
+                else
+                    res.misses++;
+            }
+            target = turn.page;
+            predictor.onPageTarget(target, now);
+        }
+        predictor.setHeld(turn.held);
+        request(target, now);
+    }
+    return res;
+}
+
+int main() {
+    const Clock::duration loadTime = std::chrono::milliseconds(6);
+    const uint32_t budgetIcons     = 256;
+    const char *names[]            = {"list order", "on demand", "predicted"};
+
+    printf("%8s %12s %10s %10s %10s %12s %10s\n", "titles", "mode", "hits", "misses", "hit %", "peak icons", "loads");
+    for (uint32_t titles : {300u, 1000u, 3000u}) {
+        std::mt19937 rng(11);
+        auto trace = MakeTrace((titles + PER_PAGE - 1) / PER_PAGE, rng);
+        for (int32_t mode = LIST_ORDER; mode <= PREDICTED; mode++) {
+            Result res = Simulate((Mode) mode, titles, budgetIcons, loadTime, trace);
+            printf("%8u %12s %10u %10u %10.1f %12u %10u\n", titles, names[mode], res.hits, res.misses,
+                   100.0f * res.hits / std::max(res.hits + res.misses, 1u), res.peakIcons, res.loads);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,134 @@
+#!/usr/bin/env python3
+#
+# Converts a PNG into an uncompressed 32 bit TGA at build time.
+#
+# libgui detects TGA data by its leading zero byte, so the embedded image is read
+# into a texture without inflating and unfiltering it on the console. Only the
+# python standard library is used, supported are 8 bit gray, RGB, palette,
+# gray + alpha and RGBA images without interlacing.
+#
+# usage: png2tga.py <input.png> <output>
+
+import struct
+import sys
+import zlib
+
+
+def paeth(a, b, c):
+    p = a + b - c
+    pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+    if pa <= pb and pa <= pc:
+        return a
+    if pb <= pc:
+        return b
+    return c
+
+
+def unfilter(data, width, height, bpp):
+    stride = width * bpp
+    rows = []
+    prev = bytearray(stride)
+    pos = 0
+    for _ in range(height):
+        ftype = data[pos]
+        line = bytearray(data[pos + 1:pos + 1 + stride])
+        pos += 1 + stride
+        if ftype == 1:
+            for i in range(bpp, stride):
+                line[i] = (line[i] + line[i - bpp]) & 0xFF
+        elif ftype == 2:
+            for i in range(stride):
+                line[i] = (line[i] + prev[i]) & 0xFF
+        elif ftype == 3:
+            for i in range(stride):
+                left = line[i - bpp] if i >= bpp else 0
+                line[i] = (line[i] + ((left + prev[i]) >> 1)) & 0xFF
+        elif ftype == 4:
+            for i in range(stride):
+                left = line[i - bpp] if i >= bpp else 0
+                upleft = prev[i - bpp] if i >= bpp else 0
+                line[i] = (line[i] + paeth(left, prev[i], upleft)) & 0xFF
+        elif ftype != 0:
+            raise ValueError("invalid filter type %d" % ftype)
+        rows.append(line)
+        prev = line
+    return rows
+
+
+def read_png(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:8] != b"\x89PNG\r\n\x1a\n":
+        raise ValueError("%s is not a png" % path)
+
+    pos = 8
+    idat = b""
+    palette = b""
+    trns = b""
+    while pos < len(data):
+        length, ctype = struct.unpack(">I4s", data[pos:pos + 8])
+        chunk = data[pos + 8:pos + 8 + length]
+        pos += 12 + length
+        if ctype == b"IHDR":
+            width, height, depth, color, _, _, interlace = struct.unpack(">IIBBBBB", chunk)
+        elif ctype == b"PLTE":
+            palette = chunk
+        elif ctype == b"tRNS":
+            trns = chunk
+        elif ctype == b"IDAT":
+            idat += chunk
+        elif ctype == b"IEND":
+            break
+
+    if depth != 8 or interlace != 0:
+        raise ValueError("%s: only 8 bit non interlaced images are supported" % path)
+
+    channels = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}[color]
+    rows = unfilter(zlib.decompress(idat), width, height, channels)
+
+    rgba = []
+    for line in rows:
+        out = bytearray(width * 4)
+        for x in range(width):
+            if color == 0:
+                g = line[x]
+                px = (g, g, g, 255)
+            elif color == 2:
+                px = (line[x * 3], line[x * 3 + 1], line[x * 3 + 2], 255)
+            elif color == 3:
+                i = line[x]
+                px = (palette[i * 3], palette[i * 3 + 1], palette[i * 3 + 2], trns[i] if i < len(trns) else 255)
+            elif color == 4:
+                g = line[x * 2]
+                px = (g, g, g, line[x * 2 + 1])
+            else:
+                px = tuple(line[x * 4:x * 4 + 4])
+            out[x * 4:x * 4 + 4] = bytes(px)
+        rgba.append(out)
+    return width, height, rgba
+
+
+def write_tga(path, width, height, rgba):
+    # type 2 (uncompressed true color), 32 bpp, 8 alpha bits, bottom-left origin
+    header = struct.pack("<BBBHHBHHHHBB", 0, 0, 2, 0, 0, 0, 0, 0, width, height, 32, 8)
+    body = bytearray()
+    for line in reversed(rgba):
+        for x in range(width):
+            r, g, b, a = line[x * 4:x * 4 + 4]
+            body += bytes((b, g, r, a))
+    with open(path, "wb") as f:
+        f.write(header)
+        f.write(body)
+
+
+def main():
+    if len(sys.argv) != 3:
+        print("usage: %s <input.png> <output>" % sys.argv[0])
+        return 1
+    width, height, rgba = read_png(sys.argv[1])
+    write_tga(sys.argv[2], width, height, rgba)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
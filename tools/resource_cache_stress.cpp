@@ -0,0 +1,144 @@
+/****************************************************************************
+ * Host stress test of ResourceCache.
+ *
+ * Eight threads acquire and release objects of a few ids at random, 200000
+ * operations in total, with the objects dropped at once and with two of them
+ * kept alive. The create and destroy callbacks check that an id never has
+ * two live objects and that no object is destroyed twice or handed out after
+ * it was destroyed; at the end every reference count is 0 and each created
+ * object was destroyed once. Meant to be built with ThreadSanitizer as well.
+ * Run filelist.sh first, then:
+ *
+ *   g++ -std=c++17 -O1 -g -fsanitize=thread -Isrc tools/resource_cache_stress.cpp -o resource_cache_stress -lpthread
+ *   ./resource_cache_stress
+ ****************************************************************************/
+#include "resources/ResourceCache.h"
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+static std::atomic<uint32_t> failures(0);
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            failures++;                                                     \
+        }                                                                   \
+    } while (0)
+
+static const int32_t THREADS    = 8;
+static const int32_t OPERATIONS = 200000;
+//! few ids, so the threads share objects and race on creating them
+static const int32_t IDS = std::min(RECOURCE_COUNT, 6);
+//! never created, Acquire returns nullptr
+static const int32_t FAILING_ID = IDS - 1;
+
+typedef struct _Object {
+    int32_t id;
+    std::atomic<bool> destroyed;
+} Object;
+
+static std::atomic<int32_t> live[IDS];
+static std::atomic<uint32_t> creates(0);
+static std::atomic<uint32_t> destroys(0);
+//! destroyed objects stay allocated so a late use is detected instead of crashing
+static std::mutex graveyardLock;
+static std::vector<Object *> graveyard;
+
+static Object *Create(int32_t id) {
+    if (id == FAILING_ID)
+        return nullptr;
+
+    CHECK(live[id].fetch_add(1) == 0);
+    creates++;
+    std::this_thread::yield();
+    Object *object = new Object();
+    object->id     = id;
+    return object;
+}
+
+static void Destroy(Object *object) {
+    CHECK(!object->destroyed.exchange(true));
+    CHECK(live[object->id].fetch_sub(1) == 1);
+    destroys++;
+    std::lock_guard<std::mutex> lock(graveyardLock);
+    graveyard.push_back(object);
+}
+
+static void Stress(ResourceCache<Object> &cache, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<Object *> held;
+    for (int32_t i = 0; i < OPERATIONS / THREADS; i++) {
+        if (held.empty() || (held.size() < 8 && rng() % 2 == 0)) {
+            int32_t id     = rng() % IDS;
+            Object *object = cache.Acquire(id);
+            if (id == FAILING_ID) {
+                CHECK(object == nullptr);
+                continue;
+            }
+            CHECK(object != nullptr && object->id == id && !object->destroyed);
+            held.push_back(object);
+        } else {
+            size_t index = rng() % held.size();
+            CHECK(!held[index]->destroyed);
+            CHECK(cache.Release(held[index]));
+            held.erase(held.begin() + index);
+        }
+    }
+    for (Object *object : held) {
+        CHECK(cache.Release(object));
+    }
+}
+
+static void Run(uint32_t keepAlive) {
+    creates  = 0;
+    destroys = 0;
+    ResourceCache<Object> cache(Create, Destroy, keepAlive);
+
+    std::vector<std::thread> threads;
+    for (int32_t t = 0; t < THREADS; t++) {
+        threads.emplace_back(Stress, std::ref(cache), t + 1);
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    for (int32_t id = 0; id < IDS; id++) {
+        CHECK(cache.GetRefCount(id) == 0);
+    }
+    Object foreign;
+    foreign.id = 0;
+    CHECK(!cache.Release(&foreign));
+    CHECK(!cache.Release(nullptr));
+
+    cache.Trim();
+    for (int32_t id = 0; id < IDS; id++) {
+        CHECK(live[id] == 0);
+    }
+    CHECK(creates == destroys);
+    printf("keep alive %u: %u objects created and destroyed\n", keepAlive, creates.load());
+}
+
+int main() {
+    if (IDS < 2) {
+        printf("Not enough resources, run filelist.sh first\n");
+        return 1;
+    }
+    Run(0);
+    Run(2);
+
+    for (Object *object : graveyard) {
+        delete object;
+    }
+
+    if (failures > 0) {
+        printf("%u checks failed\n", failures.load());
+        return 1;
+    }
+    printf("all checks passed\n");
+    return 0;
+}
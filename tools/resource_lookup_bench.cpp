@@ -0,0 +1,75 @@
+/****************************************************************************
+ * Host micro benchmark of the resource name lookup.
+ *
+ * Compares the former strcasecmp walk and std::string keyed cache with the
+ * perfect hash generated by filelist.sh. Run filelist.sh first, then:
+ *
+ *   g++ -std=c++17 -O2 -Isrc tools/resource_lookup_bench.cpp -o lookup_bench
+ *   ./lookup_bench
+ ****************************************************************************/
+#include "resources/filelist_ids.h"
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <stdio.h>
+#include <string>
+#include <strings.h>
+#include <type_traits>
+
+static const char *names[RECOURCE_COUNT];
+static std::map<std::string, int32_t> nameCache;
+static std::map<int32_t, int32_t> idCache;
+
+static int32_t LinearIndex(const char *name) {
+    for (int32_t i = 0; RecourceNames[i] != nullptr; ++i) {
+        if (strcasecmp(name, RecourceNames[i]) == 0)
+            return i;
+    }
+    return -1;
+}
+
+template<typename F>
+static double Measure(F lookup) {
+    const uint32_t rounds = 100000;
+    double best           = 1e9;
+    int64_t sink          = 0;
+
+    for (int32_t repeat = 0; repeat < 7; ++repeat) {
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t r = 0; r < rounds; ++r) {
+            for (int32_t i = 0; i < RECOURCE_COUNT; ++i) {
+                sink += lookup(names[i]);
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+        best     = std::min(best, std::chrono::duration<double, std::nano>(end - start).count() / ((double) rounds * RECOURCE_COUNT));
+    }
+
+    if (sink == 0x7fffffff)
+        printf("\n");
+    return best;
+}
+
+int main() {
+    //! volatile copy so the compiler can not fold the lookups
+    for (int32_t i = 0; i < RECOURCE_COUNT; ++i) {
+        names[i]                       = *(const char *volatile *) &RecourceNames[i];
+        nameCache[std::string(names[i])] = i;
+        idCache[i]                     = i;
+    }
+
+    printf("%d files, best of 7\n", RECOURCE_COUNT);
+    printf("index, strcasecmp walk:           %6.1f ns\n", Measure(LinearIndex));
+    printf("index, perfect hash:              %6.1f ns\n", Measure(RecourceIndex));
+    printf("cache hit, walk + std::string map: %6.1f ns\n", Measure([](const char *name) {
+               return LinearIndex(name) + nameCache.find(std::string(name))->second;
+           }));
+    printf("cache hit, hash + id map:          %6.1f ns\n", Measure([](const char *name) {
+               return idCache.find(RecourceIndex(name))->second;
+           }));
+    printf("cache hit, RESOURCE_ID + id map:   %6.1f ns\n", Measure([](const char *) {
+               return idCache.find(std::integral_constant<int32_t, RecourceIndex("font.ttf")>::value)->second;
+           }));
+
+    return 0;
+}
@@ -0,0 +1,98 @@
+/****************************************************************************
+ * Host micro benchmark of the title sort orders.
+ *
+ * Compares sorting the whole list by name after one title was renamed, with
+ * case insensitive std::string comparisons as a grid sorted by name would do
+ * on every relayout, against moving the title inside the orders kept by
+ * TitleSortOrder. Every order is checked against a full sort at the end.
+ *
+ *   g++ -std=c++17 -O2 -Isrc tools/title_sort_bench.cpp src/game/TitleSortOrder.cpp -o sort_bench
+ *   ./sort_bench
+ ****************************************************************************/
+#include "game/TitleSortOrder.h"
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <stdio.h>
+#include <string>
+#include <strings.h>
+#include <vector>
+
+struct Title {
+    uint64_t titleId;
+    uint32_t appType;
+    std::string name;
+};
+
+static std::string RandomName(std::mt19937 &rng) {
+    static const char *words[] = {"Super", "mario", "Kart", "zelda", "Splatoon", "the", "Legend", "of", "Party", "Xenoblade", "Chronicles", "U", "3D", "World"};
+    std::string name;
+    uint32_t count = 1 + rng() % 4;
+    for (uint32_t i = 0; i < count; i++) {
+        if (i)
+            name += ' ';
+        name += words[rng() % (sizeof(words) / sizeof(words[0]))];
+    }
+    return name;
+}
+
+static bool NameLess(const Title *a, const Title *b) {
+    int32_t res = strcasecmp(a->name.c_str(), b->name.c_str());
+    return (res != 0) ? res < 0 : a->titleId < b->titleId;
+}
+
+int main() {
+    const uint32_t titleCount = 2000;
+    const uint32_t renames    = 2000;
+
+    std::mt19937 rng(42);
+    std::vector<Title> titles(titleCount);
+    std::vector<Title *> list;
+    TitleSortOrder order;
+    for (uint32_t i = 0; i < titleCount; i++) {
+        titles[i] = {0x0005000010100000ULL + rng(), (uint32_t) (rng() % 4), RandomName(rng)};
+        list.push_back(&titles[i]);
+        order.insert(titles[i].titleId, titles[i].appType, titles[i].name);
+    }
+
+    std::vector<std::pair<uint32_t, std::string>> changes;
+    for (uint32_t i = 0; i < renames; i++) {
+        changes.emplace_back(rng() % titleCount, RandomName(rng));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (auto const &change : changes) {
+        titles[change.first].name = change.second;
+        std::sort(list.begin(), list.end(), NameLess);
+    }
+    double fullSort = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / renames;
+
+    start = std::chrono::steady_clock::now();
+    for (auto const &change : changes) {
+        order.rename(titles[change.first].titleId, change.second);
+    }
+    double incremental = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / renames;
+
+    //! check the kept orders against sorting from scratch
+    bool ok = order.size() == titleCount;
+    for (int32_t key = 0; key < SORT_KEY_COUNT; key++) {
+        std::vector<Title *> expected(list);
+        std::sort(expected.begin(), expected.end(), [key](const Title *a, const Title *b) {
+            if (key == SORT_BY_APP_TYPE && a->appType != b->appType)
+                return a->appType < b->appType;
+            if (key != SORT_BY_TITLE_ID) {
+                int32_t res = TitleSortOrder::collationKey(a->name).compare(TitleSortOrder::collationKey(b->name));
+                if (res != 0)
+                    return res < 0;
+            }
+            return a->titleId < b->titleId;
+        });
+        auto const &kept = order.get((TitleSortKey) key);
+        for (uint32_t i = 0; ok && i < titleCount; i++) {
+            ok = kept[i]->titleId == expected[i]->titleId;
+        }
+    }
+
+    printf("%u titles, one rename: full sort %.2f us, kept orders %.2f us, orders %s\n", titleCount, fullSort, incremental, ok ? "match" : "DIFFER");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,31 @@
+#!/usr/bin/env python3
+#
+# Compresses an embedded asset with zlib at build time.
+#
+# Layout: "LZ01", uncompressed size as big endian uint32, zlib stream.
+# Resources inflates it on first access, see Resources::Decompress().
+#
+# usage: zpack.py <input> <output>
+
+import struct
+import sys
+import zlib
+
+MAGIC = b"LZ01"
+
+
+def main():
+    if len(sys.argv) != 3:
+        print("usage: %s <input> <output>" % sys.argv[0])
+        return 1
+    with open(sys.argv[1], "rb") as f:
+        data = f.read()
+    with open(sys.argv[2], "wb") as f:
+        f.write(MAGIC)
+        f.write(struct.pack(">I", len(data)))
+        f.write(zlib.compress(data, 9))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())